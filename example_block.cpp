@@ -0,0 +1,95 @@
+/*
+	Optimized scalable arithmetic encoder/decoder implementation by:
+		Dimitris Vlachos(DimitrisV22@gmail.com) , 2014
+		(https://github.com/DimitrisVlachos/lib_bitstreams)
+
+	Based on non-scalable basic implementations of :
+		Mark Nelson
+		Dimitry Subbotin (carry-less implementation of range coder)
+		Sachin Garg
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+*/
+
+#include "scalable_block_ac.hpp"
+#include "scalable_block_adc.hpp"
+
+static const uint32_t k_block_size = 1U << 16U;
+
+bool encode(const char* in_file,const char* out_file) {
+	file_streams::file_stream_if* rd = new file_streams::file_stream_reader_c(in_file);
+	bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out;
+	scalable_block_ac_c<file_streams::file_stream_writer_c,uint32_t,uint64_t> coder;
+	uint8_t* buffer = new uint8_t[k_block_size];
+
+	if ((!rd) || (!buffer)) {
+		delete rd;
+		delete[] buffer;
+		return false;
+	}
+
+	if (!out.open(out_file)) {
+		delete rd;
+		delete[] buffer;
+		return false;
+	}
+
+	coder.init(&out,k_block_size);
+
+	for (uint32_t i = 0,j = rd->size();i < j;) {
+		uint32_t len = 0;
+
+		for (;(len < k_block_size) && (i < j);++len,++i)
+			buffer[len] = rd->read();
+
+		coder.encode_block(buffer,len);
+	}
+
+	coder.finish();
+	out.close();
+	delete rd;
+	delete[] buffer;
+	return true;
+}
+
+bool decode(const char* in_file,const char* out_file) {
+	file_streams::file_stream_if* wr = new file_streams::file_stream_writer_c(out_file);
+	bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> in;
+	scalable_block_adc_c<file_streams::file_stream_reader_c,uint32_t,uint64_t> decoder;
+	uint8_t* buffer = new uint8_t[k_block_size];
+	uint32_t len;
+
+	if ((!wr) || (!buffer)) {
+		delete wr;
+		delete[] buffer;
+		return false;
+	}
+
+	if (!in.open(in_file)) {
+		delete wr;
+		delete[] buffer;
+		return false;
+	}
+
+	decoder.init(&in);
+
+	while (decoder.decode_block(buffer,k_block_size,len)) {
+		for (uint32_t i = 0;i < len;++i)
+			wr->write(buffer[i]);
+	}
+
+	delete wr;
+	delete[] buffer;
+	return true;
+}
+
+int main() {
+	encode("scalable_ac.hpp","out.bin");
+	decode("out.bin","out_scalable_ac.hpp");
+	return 0;
+}
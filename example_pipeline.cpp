@@ -0,0 +1,77 @@
+/*
+	Optimized scalable arithmetic encoder/decoder implementation by:
+		Dimitris Vlachos(DimitrisV22@gmail.com) , 2014
+		(https://github.com/DimitrisVlachos/lib_bitstreams)
+
+	Based on non-scalable basic implementations of :
+		Mark Nelson
+		Dimitry Subbotin (carry-less implementation of range coder)
+		Sachin Garg
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+*/
+
+#include "scalable_pipeline.hpp"
+#include "scalable_ac.hpp"
+#include "scalable_adc.hpp"
+
+
+bool encode(const char* in_file,const char* out_file) {
+	scalable_async_reader_c rd;
+	scalable_async_writer_c wr;
+	bit_streams::bit_stream_writer_c<scalable_async_writer_c> out;
+	scalable_ac_c<scalable_async_writer_c,uint32_t,uint64_t> coder;
+
+	if (!rd.open(in_file))
+		return false;
+
+	if ((!wr.open(out_file)) || (!out.open(&wr)))
+		return false;
+
+	coder.init(256 + 1,&out); //256 is eof symbol
+
+	for (uint32_t i = 0,j = rd.size();i < j;++i)
+		coder.encode_symbol(rd.read());
+
+	coder.encode_symbol(256); // eof
+	coder.flush();
+	out.close();
+	wr.close();
+	return true;
+}
+
+bool decode(const char* in_file,const char* out_file) {
+	scalable_async_reader_c rd;
+	scalable_async_writer_c wr;
+	bit_streams::bit_stream_reader_c<scalable_async_reader_c> in;
+	scalable_adc_c<scalable_async_reader_c,uint32_t,uint64_t> decoder;
+
+	if ((!rd.open(in_file)) || (!in.open(&rd)))
+		return false;
+
+	if (!wr.open(out_file))
+		return false;
+
+	decoder.init(256 + 1,&in); //256 is eof symbol
+	uint32_t symbol;
+
+	while (1) {
+		symbol = decoder.decode_symbol();
+		if (256==symbol)break;
+		wr.write(symbol);
+	}
+
+	wr.close();
+	return true;
+}
+
+int main() {
+	encode("scalable_ac.hpp","out.bin");
+	decode("out.bin","out_scalable_ac.hpp");
+	return 0;
+}
@@ -41,6 +41,13 @@
 	coder.restore_state(state,true); //2nd argument deletes state without the need to call coder.delete_state(state); 
 
 
+	Example usage of adaptation policies (see scalable_policy.hpp) :
+		scalable_ac_c<file_streams::file_stream_writer_c,uint16_t,uint32_t,scalable_tuned_policy_c<8,8,2,2> > coder;
+
+	Example usage of run mode (long runs of a dominant symbol) :
+	coder.init(max_entropy,&out);
+	coder.enable_run_mode(0);	//0s leave the model , other symbols cost a run length on top , decoder must enable it too
+
 	Example usage of calculating encoding cost (in bits) :
 
 	scalable_ac_state_t* state = coder.save_state(); //Save state
@@ -53,44 +60,61 @@
 	
 */
 
-#include "bit_streams.hpp"
+#include "scalable_range_enc.hpp"
+#include "scalable_policy.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t,class adaptation_policy_t = scalable_default_policy_c>
+class scalable_ac_c : public scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> range_t;
 
-template <class writer_type_c,typename probability_type_t,typename max_range_type_t >
-class scalable_ac_c {
 	public:
+	static const uint32_t k_run_buckets = 32;
+	static const uint32_t k_run_mantissa_bits = 2;	//Modeled bits below the leading one of a run length
+	static const uint32_t k_run_mantissa_syms = 1U << k_run_mantissa_bits;
+
 	struct scalable_ac_state_t {
 		max_range_type_t high,low,underflow_count;
 		max_range_type_t tmp_range;
 		max_range_type_t max_syms;
 		probability_type_t* probability;
+		typename adaptation_policy_t::state_t policy_state;
+		probability_type_t run_model[k_run_buckets + 1];
+		probability_type_t run_mantissa[k_run_buckets][k_run_mantissa_syms + 1];
+		uint64_t run_length;
+		max_range_type_t run_symbol;
+		bool run_enabled;
 		bool flushed;
 	};
 
 	private:
-	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
-	static const max_range_type_t k_hi_bit = k_max_bits - 1;
-	static const max_range_type_t k_low_bit = k_max_bits - 2;
-	static const max_range_type_t k_low_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
-	static const max_range_type_t k_low_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2));
-	static const max_range_type_t k_hi_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1)) - (max_range_type_t)1;
-	static const max_range_type_t k_hi_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1));
-	static const max_range_type_t k_max_range =  (max_range_type_t)k_low_bit_mask;
-	static const max_range_type_t k_probability_range_mask = (max_range_type_t)( ((probability_type_t)-1)  ) ;
- 	
+	using range_t::k_max_bits;
+	using range_t::k_max_range;
+	using range_t::m_stream;
+	using range_t::m_high;
+	using range_t::m_low;
+	using range_t::m_underflow_count;
+	using range_t::m_tmp_range;
+	using range_t::m_flushed;
+	using range_t::reset_range;
+	using range_t::finish_range;
+	using range_t::pad_range;
+	using range_t::range_code_interval;
+
+	static const uint32_t k_run_raw_bits = (k_max_bits < (max_range_type_t)11) ? (uint32_t)(k_max_bits - (max_range_type_t)3) : 8U;	//1 << bits must stay below k_max_range
+	static const uint64_t k_max_run_length = (uint64_t)0xfffffffeU;	//Per coded length , length + 1 fits 32 bits
 
-	private:
-	bit_streams::bit_stream_writer_c<writer_type_c>* m_stream;
-	max_range_type_t m_high,m_low,m_underflow_count;
-	max_range_type_t m_tmp_range;
 	max_range_type_t m_max_syms;
 	probability_type_t* m_probability;
-	bool m_flushed;
+	typename adaptation_policy_t::state_t m_policy_state;
+	probability_type_t m_run_model[k_run_buckets + 1];	//Cumulative model of floor(log2(run length + 1))
+	probability_type_t m_run_mantissa[k_run_buckets][k_run_mantissa_syms + 1];	//Top bits below the leading one , per bucket
+	uint64_t m_run_length;	//Run symbols since the last coded run length
+	max_range_type_t m_run_symbol;
+	bool m_run_enabled;
 
 	public:
-	scalable_ac_c() : 	m_stream(0),m_high( (max_range_type_t)( ((probability_type_t)-1)  )),
-	m_low(0),m_max_syms(0),
-	m_underflow_count(0),
-	m_tmp_range(0),m_flushed(false),m_probability(0) { }
+	scalable_ac_c() : m_max_syms(0),m_probability(0),
+	m_run_length(0),m_run_symbol(0),m_run_enabled(false) { }
 	~scalable_ac_c() {
 		flush();
 		delete[] m_probability;
@@ -116,6 +140,18 @@ class scalable_ac_c {
 		state->max_syms = m_max_syms;
 		state->flushed = m_flushed;
 		state->tmp_range = m_tmp_range;
+		state->policy_state = m_policy_state;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			state->run_model[i] = m_run_model[i];
+
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				state->run_mantissa[i][j] = m_run_mantissa[i][j];
+		}
+
+		state->run_length = m_run_length;
+		state->run_symbol = m_run_symbol;
+		state->run_enabled = m_run_enabled;
 		return state;
 	}
 
@@ -150,6 +186,18 @@ class scalable_ac_c {
 		m_max_syms = state->max_syms;
 		m_flushed = state->flushed;
 		m_tmp_range = state->tmp_range;
+		m_policy_state = state->policy_state;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			m_run_model[i] = state->run_model[i];
+
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				m_run_mantissa[i][j] = state->run_mantissa[i][j];
+		}
+
+		m_run_length = state->run_length;
+		m_run_symbol = state->run_symbol;
+		m_run_enabled = state->run_enabled;
 
 		if (cleanup)
 			delete_state(state);
@@ -166,25 +214,95 @@ class scalable_ac_c {
 			return false;
 
 		if ((!m_flushed) || force) { 
-			++m_underflow_count;
-			m_stream->write((m_low>>k_low_bit)&((max_range_type_t)1),1);
-			const max_range_type_t bstate = ((m_low>>k_low_bit)^((max_range_type_t)1))&1;
-			const uint64_t uf_mask = (bstate) ? (((uint64_t)-1)) : (uint64_t)0;
+			if (m_run_length)
+				emit_run();
+
+			finish_range();
+			return false;
+		}
 
-			for (;m_underflow_count >= 64U;m_underflow_count -= 64U) 
-				m_stream->write(uf_mask,64U);
-					
-			if (m_underflow_count)
-				m_stream->write(uf_mask,m_underflow_count);
+		return false;
+	}
+
+	//Flushes and pads the stream so that the decoder's preamble read-ahead ends exactly where this
+	//coder's output ends. Other data (or another coder) may then follow in the same bitstream.
+	bool flush_padded() {
+		if ((!m_stream) || (m_flushed))
+			return false;
+
+		flush();
+		pad_range();
+		return true;
+	}
 
-			m_underflow_count=(max_range_type_t)0;
+	//Closes the current segment with flush_padded() and restarts the range coder right after it.
+	//The model is kept so a decoder can resume at this point from a copy of it (see scalable_sync_ac.hpp)
+	bool restart() {
+		if (!m_stream)
+			return false;
 
+		flush_padded();
+		reset_range(m_stream);
+		return true;
+	}
+
+	//Drops the stream without flushing (for coders used only through estimate_cost)
+	inline void detach() {
+		m_stream = 0;
+		m_run_length = 0;
+		m_flushed = true;
+	}
 
-			m_flushed=true;
+	//symbol is never coded with the model : every other symbol is preceded by the length of the run of
+	//symbol before it (0 included) , so isolated occurrences cost no model symbol either.
+	//Call after init() , the decoder must enable the same symbol at the same point.
+	//reset() keeps run mode , init() disables it. estimate_cost() does not model runs
+	bool enable_run_mode(const max_range_type_t symbol) {
+		if ((!m_probability) || (symbol >= m_max_syms))
 			return false;
+
+		if (m_run_length)
+			emit_run();
+
+		reset_run_model();
+		m_run_symbol = symbol;
+		m_run_enabled = true;
+		return true;
+	}
+
+	void disable_run_mode() {
+		if (m_run_length)
+			emit_run();
+
+		m_run_enabled = false;
+	}
+
+	//Starts a new message from a pre-trained model (see scalable_prototype.hpp).
+	//The model is copied into the storage owned since the last init() : no allocation while max_symbols matches
+	bool reset(const probability_type_t* model,const max_range_type_t max_symbols,bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		flush();
+		if ((!stream) || (!model) || (!max_symbols))
+			return false;
+
+		if ((!m_probability) || (m_max_syms != max_symbols)) {
+			delete[] m_probability;
+			m_probability = new probability_type_t[max_symbols + 1];
+			m_max_syms = max_symbols;
+
+			if (!m_probability)
+				return false;
 		}
 
-		return false;
+		for (max_range_type_t i = 0;i <= max_symbols;++i)
+			m_probability[i] = model[i];
+
+		adaptation_policy_t::init(m_policy_state);
+		reset_run_model();
+		if (m_run_symbol >= max_symbols)
+			m_run_enabled = false;
+
+		reset_range(stream);
+		return true;
 	}
 
 	 bool init(max_range_type_t max_symbols,bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
@@ -192,13 +310,10 @@ class scalable_ac_c {
 		if ((!stream) || (!max_symbols))
 			return false;
 
-		m_high=  (max_range_type_t)( ((probability_type_t)-1)  );
-		 
-		m_low=0;
-		m_underflow_count=0;
-		m_tmp_range=0;
-		m_flushed=false; 
-		m_stream = stream;
+		reset_range(stream);
+		m_run_enabled = false;
+		m_run_length = 0;
+		adaptation_policy_t::init(m_policy_state);
 		 
 		delete[] m_probability;
 		m_probability = new probability_type_t[max_symbols + 1];
@@ -220,13 +335,10 @@ class scalable_ac_c {
 		if ((!stream) || (!max_symbols))
 			return false;
 
-		m_high= (max_range_type_t)( ((probability_type_t)-1)  );
-		 
-		m_low=0;
-		m_underflow_count=0;
-		m_tmp_range=0;
-		m_flushed=false; 
-		m_stream = stream;
+		reset_range(stream);
+		m_run_enabled = false;
+		m_run_length = 0;
+		adaptation_policy_t::init(m_policy_state);
 		 
 		delete[] m_probability;
 		m_probability = new probability_type_t[max_symbols + 1];
@@ -261,23 +373,19 @@ class scalable_ac_c {
 	} 
 
 	void encode_symbol(const max_range_type_t s) {
-		range_code(s);
-
-		register probability_type_t* p0;
-		register probability_type_t* p1;
+		if (m_run_enabled) {
+			if (s == m_run_symbol) {
+				if (++m_run_length == k_max_run_length)
+					emit_run();
 
+				return;
+			}
 
-		p0 = &m_probability[s + (max_range_type_t)1];
-		p1 = &m_probability[m_max_syms + (max_range_type_t)1];
-		if (p0 < p1) {
-			do {
-				*(p0++) += (probability_type_t)1U;
-			} while (p0 < p1);
+			emit_run();
 		}
- 
 
-		if (m_probability[m_max_syms] >= k_max_range)
-			scale_model();	
+		range_code(s);
+		update_model(s);
 	}
 
 	//Remember to save/restore states!
@@ -285,98 +393,110 @@ class scalable_ac_c {
 	const max_range_type_t estimate_cost(const base_t s) {
 		max_range_type_t cost = range_code(s,true);
 
+		update_model(s);
+		return cost;
+	}
+
+	//Remember to save/restore states!
+	template <typename base_t>
+	const max_range_type_t estimate_cost(const base_t* s,const max_range_type_t count,const max_range_type_t lim = (max_range_type_t)-1) {
+		max_range_type_t cost = 0;
+		for (max_range_type_t i = 0,j = count;i < j;++i) {
+			cost += estimate_cost(*(s++));
+			if (cost > lim)
+				break;
+		}
+
+		return cost;
+	}
+
+	private:
+
+	inline void update_model(const max_range_type_t s) {
 		register probability_type_t* p0;
 		register probability_type_t* p1;
+		const probability_type_t inc = (probability_type_t)adaptation_policy_t::increment(m_policy_state);
 
 
 		p0 = &m_probability[s + (max_range_type_t)1];
 		p1 = &m_probability[m_max_syms + (max_range_type_t)1];
 		if (p0 < p1) {
 			do {
-				*(p0++) += (probability_type_t)1U;
+				*(p0++) += inc;
 			} while (p0 < p1);
 		}
  
 
-		if (m_probability[m_max_syms] >= k_max_range)
+		if (m_probability[m_max_syms] >= adaptation_policy_t::limit(k_max_range))
 			scale_model();	
-
-		return cost;
 	}
 
-	//Remember to save/restore states!
-	template <typename base_t>
-	const max_range_type_t estimate_cost(const base_t* s,const max_range_type_t count,const max_range_type_t lim = (max_range_type_t)-1) {
-		max_range_type_t cost = 0;
-		for (max_range_type_t i = 0,j = count;i < j;++i) {
-			cost += estimate_cost(*(s++));
-			if (cost > lim)
-				break;
-		}
+	void reset_run_model() {
+		m_run_length = 0;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			m_run_model[i] = (probability_type_t)i;
 
-		return cost;
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				m_run_mantissa[i][j] = (probability_type_t)j;
+		}
 	}
 
-	private:
+	//Run length n as n + 1 : floor(log2(n + 1)) with the run model , up to k_run_mantissa_bits below the
+	//leading one with that bucket's model and the rest raw (k_run_raw_bits at a time)
+	void emit_run() {
+		const uint64_t len = m_run_length + (uint64_t)1;	//Up to 32 bits : shifts stay on 64 bits
+		uint32_t bucket = 0;
+
+		m_run_length = 0;
+		while (len >> (uint64_t)(bucket + 1U))
+			++bucket;
 
-	void scale_model() {
-		register probability_type_t* p0 = &m_probability[(max_range_type_t)0];
-		register probability_type_t* p1 = &m_probability[(max_range_type_t)m_max_syms + (max_range_type_t)1];
-		register probability_type_t prev = *(p0++),curr;
-		if (p0 >= p1)
+		code_run_model(m_run_model,k_run_buckets,bucket);
+		if (!bucket)
 			return;
 
-		do {
-			curr = *(p0) >> (probability_type_t)1;
-			if (curr <= prev)
-				curr = prev + (probability_type_t)1;
-	
-			*(p0++) = curr;
-			prev = curr;
-		} while (p0 < p1);
+		const uint32_t bits = (bucket < k_run_mantissa_bits) ? bucket : k_run_mantissa_bits;
+		uint32_t left = bucket - bits;
+
+		code_run_model(m_run_mantissa[bucket],1U << bits,(uint32_t)(len >> (uint64_t)left) & ((1U << bits) - 1U));
+		while (left) {
+			const uint32_t n = (left > k_run_raw_bits) ? k_run_raw_bits : left;
+			left -= n;
+
+			const max_range_type_t v = (max_range_type_t)((len >> (uint64_t)left) & (uint64_t)((1U << n) - 1U));
+			range_code_interval(v,v + (max_range_type_t)1,(max_range_type_t)1 << (max_range_type_t)n);
+		}
 	}
 
+	//Codes sym of a small cumulative model (+1 per symbol , halved at k_max_range)
+	void code_run_model(probability_type_t* model,const uint32_t syms,const uint32_t sym) {
+		range_code_interval(model[sym],model[sym + 1U],model[syms]);
+		for (uint32_t i = sym + 1U;i <= syms;++i)
+			++model[i];
 
-	max_range_type_t range_code(max_range_type_t symbol,const bool simulate = false) {
-		const max_range_type_t sym_low = (max_range_type_t)m_probability[symbol];
-		const max_range_type_t sym_high = (max_range_type_t)m_probability[symbol + (max_range_type_t)1];
-		const max_range_type_t max_range = (max_range_type_t)m_probability[m_max_syms];
-		max_range_type_t cost = 0;
+		if (model[syms] >= k_max_range)
+			scale_run_model(model,syms);
+	}
 
-		m_tmp_range=(m_high-m_low)+(max_range_type_t)1;
-		m_high = m_low + ((m_tmp_range*sym_high)/max_range)- (max_range_type_t)1;
-		m_low = m_low + ((m_tmp_range*sym_low )/max_range);
-
-		do {
-			if ((m_high & k_hi_bit_val)==(m_low & k_hi_bit_val)) {
-				cost += m_underflow_count + 1;
-				if (!simulate) {
-					m_stream->write(m_high>>k_hi_bit,1);
-					const max_range_type_t bstate = (m_high>>k_hi_bit)^(max_range_type_t)1;
-					const uint64_t uf_mask = (bstate) ? (((uint64_t)-1)) : (uint64_t)0;
-
-				
-					for (;m_underflow_count >= 64U;m_underflow_count -= 64U) 
-						m_stream->write(uf_mask,64U);
-					
-					if (m_underflow_count)
-						m_stream->write(uf_mask,m_underflow_count);
-				}
-				m_underflow_count=(max_range_type_t)0;
-
-			} else {
-				if((m_low & k_low_bit_val) && !(m_high & k_low_bit_val)) {
-					++m_underflow_count;
-					m_low	 &=	k_low_bit_mask;
-					m_high |=	k_low_bit_val;
-				}
-				else break;
-			}
+	void scale_run_model(probability_type_t* model,const uint32_t syms) {
+		for (uint32_t i = 1;i <= syms;++i) {
+			probability_type_t curr = model[i] >> (probability_type_t)1;
+			if (curr <= model[i - 1])
+				curr = model[i - 1] + (probability_type_t)1;
 
-			m_low = (m_low<<(max_range_type_t)1) &	k_probability_range_mask;
-			m_high = ((m_high<<(max_range_type_t)1)|(max_range_type_t)1) & k_probability_range_mask;
-		} while (1);
-		return cost;
+			model[i] = curr;
+		}
+	}
+
+	inline void scale_model() {
+		adaptation_policy_t::rescale(m_policy_state,m_probability,m_max_syms,adaptation_policy_t::limit(k_max_range));
+	}
+
+
+	inline max_range_type_t range_code(max_range_type_t symbol,const bool simulate = false) {
+		return range_code_interval((max_range_type_t)m_probability[symbol],(max_range_type_t)m_probability[symbol + (max_range_type_t)1],
+									(max_range_type_t)m_probability[m_max_syms],simulate);
 	}
 };
 
@@ -34,47 +34,91 @@
 
 		...
 	coder.restore_state(state,true); //2nd argument deletes state without the need to call coder.delete_state(state); 
+
+	Example usage of run mode (must match the encoder's enable_run_mode()) :
+	coder.init(max_entropy,&in);
+	coder.enable_run_mode(0);
+
+	The adaptation policy (see scalable_policy.hpp) must match the encoder's.
 */
 
 #ifndef __scalable_adc_hpp__
 #define __scalable_adc_hpp__
 
-template <class reader_type_c,typename probability_type_t,typename max_range_type_t>
-class scalable_adc_c {
+#include "scalable_range_dec.hpp"
+#include "scalable_policy.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t,class adaptation_policy_t = scalable_default_policy_c>
+class scalable_adc_c : public scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> range_t;
+
 	public:
+	static const uint32_t k_run_buckets = 32;
+	static const uint32_t k_run_mantissa_bits = 2;
+	static const uint32_t k_run_mantissa_syms = 1U << k_run_mantissa_bits;
+
 	struct scalable_adc_state_t {
 		max_range_type_t high,low;
 		max_range_type_t tmp_range;
 		max_range_type_t max_syms;
 		max_range_type_t code;
 		probability_type_t* probability;
+		typename adaptation_policy_t::state_t policy_state;
+		probability_type_t run_model[k_run_buckets + 1];
+		probability_type_t run_mantissa[k_run_buckets][k_run_mantissa_syms + 1];
+		uint64_t run_left;
+		bool run_due;
+		max_range_type_t run_symbol;
+		bool run_enabled;
 	};
+
 	private:
-	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
-	static const max_range_type_t k_hi_bit = k_max_bits - (max_range_type_t)1;
-	static const max_range_type_t k_low_bit = k_max_bits - (max_range_type_t)2;
-	static const max_range_type_t k_low_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
-	static const max_range_type_t k_low_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2));
-	static const max_range_type_t k_hi_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1)) - (max_range_type_t)1;
-	static const max_range_type_t k_hi_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1));
-	static const max_range_type_t k_max_range =  (max_range_type_t)k_low_bit_mask;
-	static const max_range_type_t k_probability_range_mask = (max_range_type_t)( ((probability_type_t)-1)  );
-
-	bit_streams::bit_stream_reader_c<reader_type_c>* m_stream;
-	max_range_type_t m_high,m_low;
-	max_range_type_t m_tmp_range;
+	using range_t::k_max_bits;
+	using range_t::k_max_range;
+	using range_t::m_stream;
+	using range_t::m_high;
+	using range_t::m_low;
+	using range_t::m_tmp_range;
+	using range_t::m_code;
+	using range_t::reset_range;
+	using range_t::get_current_prob;
+	using range_t::remove_range_interval;
+
+	static const uint32_t k_run_raw_bits = (k_max_bits < (max_range_type_t)11) ? (uint32_t)(k_max_bits - (max_range_type_t)3) : 8U;
+	static const uint64_t k_max_run_length = (uint64_t)0xfffffffeU;
+
 	max_range_type_t m_max_syms;
-	max_range_type_t m_code;
 	probability_type_t* m_probability;
+	typename adaptation_policy_t::state_t m_policy_state;
+	probability_type_t m_run_model[k_run_buckets + 1];
+	probability_type_t m_run_mantissa[k_run_buckets][k_run_mantissa_syms + 1];
+	uint64_t m_run_left;	//Pending symbols of the last decoded run
+	bool m_run_due;	//A run length precedes the next plain symbol
+	max_range_type_t m_run_symbol;
+	bool m_run_enabled;
 
 	public:
-	scalable_adc_c() : m_stream(0),m_probability(0) {}
+	scalable_adc_c() : m_max_syms(0),m_probability(0),m_run_left(0),m_run_due(true),m_run_symbol(0),m_run_enabled(false) {}
 	~scalable_adc_c() { delete[] m_probability; }
 
 	inline probability_type_t* get_model() {
 		return m_probability;
 	}
 
+	//Counterpart of scalable_ac_c::restart() : resets the range decoder and reads the next segment's preamble.
+	//The model is kept (restore_state() may replace it first) , stream switches the input if set
+	bool restart(bit_streams::bit_stream_reader_c<reader_type_c>* stream = 0) {
+		if (stream)
+			m_stream = stream;
+
+		if ((!m_stream) || (!m_probability))
+			return false;
+
+		reset_range(m_stream);
+		m_run_due = true;	//The encoder's flush coded any pending run
+		return true;
+	}
+
 	scalable_adc_state_t* save_state() {
 		scalable_adc_state_t* state = new scalable_adc_state_t();
 		if (!state)
@@ -94,6 +138,19 @@ class scalable_adc_c {
 		state->max_syms = m_max_syms;
 		state->code = m_code;
 		state->tmp_range = m_tmp_range;
+		state->policy_state = m_policy_state;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			state->run_model[i] = m_run_model[i];
+
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				state->run_mantissa[i][j] = m_run_mantissa[i][j];
+		}
+
+		state->run_left = m_run_left;
+		state->run_due = m_run_due;
+		state->run_symbol = m_run_symbol;
+		state->run_enabled = m_run_enabled;
 		return state;
 	}
 
@@ -127,6 +184,19 @@ class scalable_adc_c {
 		m_max_syms = state->max_syms;
 		m_code = state->code;
 		m_tmp_range = state->tmp_range;
+		m_policy_state = state->policy_state;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			m_run_model[i] = state->run_model[i];
+
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				m_run_mantissa[i][j] = state->run_mantissa[i][j];
+		}
+
+		m_run_left = state->run_left;
+		m_run_due = state->run_due;
+		m_run_symbol = state->run_symbol;
+		m_run_enabled = state->run_enabled;
 
 		if (cleanup)
 			delete_state(state);
@@ -134,7 +204,37 @@ class scalable_adc_c {
 		return true;
 	}
 
+	//Counterpart of scalable_ac_c::enable_run_mode()
+	bool enable_run_mode(const max_range_type_t symbol) {
+		if ((!m_probability) || (symbol >= m_max_syms))
+			return false;
+
+		reset_run_model();
+		m_run_symbol = symbol;
+		m_run_enabled = true;
+		return true;
+	}
+
+	inline void disable_run_mode() {
+		m_run_enabled = false;
+	}
+
 	max_range_type_t decode_symbol() {
+		if (m_run_left) {
+			--m_run_left;
+			return m_run_symbol;
+		}
+
+		if (m_run_enabled && m_run_due) {
+			const uint64_t len = decode_run_length() - (uint64_t)1;
+
+			m_run_due = (len == k_max_run_length);	//The encoder splits longer runs
+			if (len) {
+				m_run_left = len - (uint64_t)1;
+				return m_run_symbol;
+			}
+		}
+
 		max_range_type_t prob = get_current_prob(m_probability[m_max_syms]);
 		max_range_type_t sym =  (m_max_syms!=0) ? m_max_syms-1 : 0;
 
@@ -144,34 +244,48 @@ class scalable_adc_c {
 		}
 		remove_range(sym);
 
-		{
-			register probability_type_t* p0;
-			register probability_type_t* p1;
+		update_model(sym);
 
-			p0 = &m_probability[sym + (max_range_type_t)1];
-			p1 = &m_probability[m_max_syms + (max_range_type_t)1];
-			if (p0 < p1) {
-				do {
-					*(p0++) += (probability_type_t)1U;
-				} while (p0 < p1);
-			}
-		}
+		m_run_due = true;
 
-		if(m_probability[m_max_syms] >= k_max_range)
-			scale_model();
-		
 		return sym;
 	}
 
+	//Counterpart of scalable_ac_c::reset()
+	bool reset(const probability_type_t* model,const max_range_type_t max_symbols,bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if ((!stream) || (!model) || (!max_symbols))
+			return false;
+
+		if ((!m_probability) || (m_max_syms != max_symbols)) {
+			delete[] m_probability;
+			m_probability = new probability_type_t[max_symbols + 1];
+			m_max_syms = max_symbols;
+
+			if (!m_probability)
+				return false;
+		}
+
+		for (max_range_type_t i = 0;i <= max_symbols;++i)
+			m_probability[i] = model[i];
+
+		adaptation_policy_t::init(m_policy_state);
+		reset_run_model();
+		if (m_run_symbol >= max_symbols)
+			m_run_enabled = false;
+
+		reset_range(stream);
+		return true;
+	}
+
 	bool init(max_range_type_t max_symbols,bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
 
 		if ((!stream) || (!max_symbols))
 			return false;
 
-		m_high =  (max_range_type_t)( ((probability_type_t)-1)  );
-		m_low=0;
-		m_tmp_range=0;
-		m_stream = stream;
+		m_run_enabled = false;
+		m_run_left = 0;
+		m_run_due = true;
+		adaptation_policy_t::init(m_policy_state);
 		 
 		delete[] m_probability;
 		m_probability = new probability_type_t[max_symbols + 1];
@@ -184,12 +298,7 @@ class scalable_adc_c {
 			m_probability[i]=i;		
 
 		 
-		m_code = 0;
-		for (max_range_type_t i = 0;i < k_max_bits;++i) {
-			m_code <<= (max_range_type_t)1;
-			m_code |= (max_range_type_t)m_stream->read(1);
-		}
-		
+		reset_range(stream);
 		return true;
 	} 
 
@@ -200,11 +309,10 @@ class scalable_adc_c {
 		if ((!stream) || (!max_symbols))
 			return false;
 
-		m_high= (max_range_type_t)( ((probability_type_t)-1)  );
-		 
-		m_low=0;
-		m_tmp_range=0; 
-		m_stream = stream;
+		m_run_enabled = false;
+		m_run_left = 0;
+		m_run_due = true;
+		adaptation_policy_t::init(m_policy_state);
 		 
 		delete[] m_probability;
 		m_probability = new probability_type_t[max_symbols + 1];
@@ -234,63 +342,97 @@ class scalable_adc_c {
 		for (max_range_type_t i=(max_range_type_t)1;i <= max_symbols;i++)
 			m_probability[i] +=m_probability[i-1]; 
 
-		m_code = 0;
-		for (max_range_type_t i = 0;i < k_max_bits;++i) {
-			m_code <<= (max_range_type_t)1;
-			m_code |= (max_range_type_t)m_stream->read(1);
-		}
-
+		reset_range(stream);
 		return true;
 	} 
 
 	private:
-	inline max_range_type_t get_current_prob(max_range_type_t range) {
-		m_tmp_range = (m_high-m_low)+(max_range_type_t)1;
-		return (max_range_type_t)(((((m_code-m_low)+(max_range_type_t)1)*range)-1)/m_tmp_range);
+	inline void scale_model() {
+		adaptation_policy_t::rescale(m_policy_state,m_probability,m_max_syms,adaptation_policy_t::limit(k_max_range));
 	}
 
-	void scale_model() {
-		register probability_type_t* p0 = &m_probability[(max_range_type_t)0];
-		register probability_type_t* p1 = &m_probability[(max_range_type_t)m_max_syms + (max_range_type_t)1];
-		register probability_type_t prev = *(p0++),curr;
-		if (p0 >= p1)
-			return;
+	inline void update_model(const max_range_type_t sym) {
+		register probability_type_t* p0;
+		register probability_type_t* p1;
+		const probability_type_t inc = (probability_type_t)adaptation_policy_t::increment(m_policy_state);
+
+		p0 = &m_probability[sym + (max_range_type_t)1];
+		p1 = &m_probability[m_max_syms + (max_range_type_t)1];
+		if (p0 < p1) {
+			do {
+				*(p0++) += inc;
+			} while (p0 < p1);
+		}
 
-		do {
-			curr = *(p0) >> (probability_type_t)1;
-			if (curr <= prev)
-				curr = prev + (probability_type_t)1;
-	
-			*(p0++) = curr;
-			prev = curr;
-		} while (p0 < p1);
+		if(m_probability[m_max_syms] >= adaptation_policy_t::limit(k_max_range))
+			scale_model();
 	}
 
+	void reset_run_model() {
+		m_run_left = 0;
+		m_run_due = true;
+		for (uint32_t i = 0;i <= k_run_buckets;++i)
+			m_run_model[i] = (probability_type_t)i;
 
-	void remove_range(max_range_type_t symbol) {
-		const max_range_type_t sym_low = (max_range_type_t)m_probability[symbol];
-		const max_range_type_t sym_high  = (max_range_type_t)m_probability[symbol + (max_range_type_t)1];
-		const max_range_type_t total_range = (max_range_type_t)m_probability[m_max_syms];
-
-		m_tmp_range = (m_high-m_low)+(max_range_type_t)1;
-		m_high = m_low+((m_tmp_range*sym_high)/total_range)-(max_range_type_t)1;
-		m_low = m_low+((m_tmp_range*sym_low )/total_range);
-
-		do {
-			if((m_high & k_hi_bit_val) == (m_low & k_hi_bit_val)) {}
-			else {
-				if((m_low & k_low_bit_val) && !(m_high	& k_low_bit_val)) {
-					m_code ^= k_low_bit_val;
-					m_low &= k_low_bit_mask;
-					m_high |= k_low_bit_val;
-				}
-				else
-					return;
-			}
-			m_low = (m_low	<< (max_range_type_t)1) &	k_probability_range_mask;
-			m_high = ((m_high << (max_range_type_t)1) |	(max_range_type_t)1) & k_probability_range_mask;
-			m_code = ( (m_code << (max_range_type_t)1) | (max_range_type_t)m_stream->read(1) ) & k_probability_range_mask;
-		} while (1);
+		for (uint32_t i = 0;i < k_run_buckets;++i) {
+			for (uint32_t j = 0;j <= k_run_mantissa_syms;++j)
+				m_run_mantissa[i][j] = (probability_type_t)j;
+		}
+	}
+
+	//Mirrors scalable_ac_c::emit_run() , returns run length + 1
+	uint64_t decode_run_length() {
+		const uint32_t bucket = decode_run_model(m_run_model,k_run_buckets);
+		if (!bucket)
+			return 1;
+
+		const uint32_t bits = (bucket < k_run_mantissa_bits) ? bucket : k_run_mantissa_bits;
+		uint64_t len = ((uint64_t)1 << (uint64_t)bits) | (uint64_t)decode_run_model(m_run_mantissa[bucket],1U << bits);
+
+		for (uint32_t left = bucket - bits;left;) {
+			const uint32_t n = (left > k_run_raw_bits) ? k_run_raw_bits : left;
+			const max_range_type_t v = get_current_prob((max_range_type_t)1 << (max_range_type_t)n);
+
+			left -= n;
+			remove_range_interval(v,v + (max_range_type_t)1,(max_range_type_t)1 << (max_range_type_t)n);
+			len = (len << (uint64_t)n) | (uint64_t)v;
+		}
+
+		return len;
+	}
+
+	//Mirrors scalable_ac_c::code_run_model()
+	uint32_t decode_run_model(probability_type_t* model,const uint32_t syms) {
+		const max_range_type_t total = (max_range_type_t)model[syms];
+		const max_range_type_t prob = get_current_prob(total);
+		uint32_t sym = syms - 1U;
+
+		while (sym && ((max_range_type_t)model[sym] > prob))
+			--sym;
+
+		remove_range_interval(model[sym],model[sym + 1U],total);
+		for (uint32_t i = sym + 1U;i <= syms;++i)
+			++model[i];
+
+		if (model[syms] >= k_max_range)
+			scale_run_model(model,syms);
+
+		return sym;
+	}
+
+	void scale_run_model(probability_type_t* model,const uint32_t syms) {
+		for (uint32_t i = 1;i <= syms;++i) {
+			probability_type_t curr = model[i] >> (probability_type_t)1;
+			if (curr <= model[i - 1])
+				curr = model[i - 1] + (probability_type_t)1;
+
+			model[i] = curr;
+		}
+	}
+
+	inline void remove_range(max_range_type_t symbol) {
+		remove_range_interval((max_range_type_t)m_probability[symbol],(max_range_type_t)m_probability[symbol + (max_range_type_t)1],
+								(max_range_type_t)m_probability[m_max_syms]);
 	}
 };
 
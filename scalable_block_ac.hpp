@@ -0,0 +1,349 @@
+#ifndef __scalable_block_ac_hpp__
+#define __scalable_block_ac_hpp__
+
+/*
+	Block level encoder with automatic mode selection.
+
+	Each block is evaluated as :
+		stored		: raw 8 bits per symbol
+		static		: header of normalized frequencies + tANS payload (scalable_tans_enc_c , never adapts)
+		adaptive	: scalable_ac_c starting from a uniform model
+
+	The static cost follows from the block histogram (header + sum of f * log2(table / norm)) ,
+	the adaptive one from estimate_cost() (early-out at the best cost so far). The smallest is written.
+
+	With parallel (the default) encode() evaluates the upcoming blocks in worker threads (one per core ,
+	up to k_max_workers) while the current block is being written.
+
+	Block layout :
+		2 bits mode | 32 bits length | [static header] | payload
+
+	Static header (only symbols present in the block) :
+		8 bits present - 1 | symbols (present x 8 bits , or a 256 bit map when shorter) |
+		4 bits width | present x width bits of norm - 1 (norms sum to 1 << k_static_log)
+
+	Adaptive payloads are closed with flush_padded() so blocks can be concatenated in one bitstream ,
+	the tANS decoder consumes exactly the bits of its payload. A k_mode_end marker (written by finish())
+	terminates the stream.
+
+	Example usage :
+		bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out; //requires my bitstreams lib
+		scalable_block_ac_c<file_streams::file_stream_writer_c,uint32_t,uint64_t> coder;
+
+		out.open("out");
+		coder.init(&out);				//or init(&out,block_size,false) to evaluate blocks serially
+		coder.encode(buffer,len);	//splits into blocks of block_size
+		coder.finish();
+		out.close();
+*/
+
+#include <thread>
+#include "scalable_ac.hpp"
+#include "scalable_tans_enc.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_block_ac_c {
+	public:
+	enum block_mode_e {
+		k_mode_stored = 0,
+		k_mode_static = 1,
+		k_mode_adaptive = 2,
+		k_mode_end = 3
+	};
+
+	static const uint32_t k_mode_bits = 2;
+	static const uint32_t k_length_bits = 32;
+	static const uint32_t k_width_bits = 4;
+	static const uint32_t k_symbols = 256;
+	static const uint32_t k_static_log = 12;
+	static const uint32_t k_default_block_size = 1U << 16U;
+	static const uint32_t k_max_workers = 8;
+
+	private:
+	typedef scalable_ac_c<writer_type_c,probability_type_t,max_range_type_t> coder_t;
+	typedef scalable_tans_enc_c<writer_type_c,probability_type_t,max_range_type_t,k_static_log> static_coder_t;
+	typedef scalable_tans_table_c<probability_type_t,max_range_type_t,k_static_log> table_t;
+
+	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
+	static const max_range_type_t k_no_cost = (max_range_type_t)-1;
+	static const uint32_t k_log_frac_bits = 16;
+
+	//Outcome of a block evaluation : everything write_block() needs
+	struct block_plan_t {
+		uint32_t freqs[k_symbols];
+		probability_type_t norm[k_symbols];
+		uint32_t mode;
+	};
+
+	bit_streams::bit_stream_writer_c<writer_type_c>* m_stream;
+	uint32_t m_block_size;
+	uint32_t m_workers;
+
+	public:
+	scalable_block_ac_c() : m_stream(0),m_block_size(k_default_block_size),m_workers(0) { }
+
+	bool init(bit_streams::bit_stream_writer_c<writer_type_c>* stream,const uint32_t block_size = k_default_block_size,const bool parallel = true) {
+		if ((!stream) || (!block_size))
+			return false;
+
+		m_stream = stream;
+		m_block_size = block_size;
+		m_workers = 0;
+		if (parallel) {
+			const uint32_t cores = (uint32_t)std::thread::hardware_concurrency();
+			m_workers = (!cores) ? 2U : ((cores > k_max_workers) ? k_max_workers : cores);
+		}
+
+		return true;
+	}
+
+	bool encode(const uint8_t* data,const uint32_t len) {
+		const uint32_t blocks = (uint32_t)(((uint64_t)len + (uint64_t)m_block_size - (uint64_t)1) / (uint64_t)m_block_size);
+
+		if (!m_stream)
+			return false;
+
+		if (!m_workers) {
+			for (uint32_t b = 0;b < blocks;++b)
+				encode_block(data + block_offset(b),block_length(b,len));
+
+			return true;
+		}
+
+		//Slot b % m_workers holds block b : it is evaluated while the blocks before it are written
+		block_plan_t plans[k_max_workers];
+		std::thread workers[k_max_workers];
+		uint32_t next = 0;
+
+		for (;(next < blocks) && (next < m_workers);++next)
+			workers[next] = std::thread(plan_block,data + block_offset(next),block_length(next,len),m_stream,&plans[next]);
+
+		for (uint32_t b = 0;b < blocks;++b) {
+			const uint32_t slot = b % m_workers;
+
+			workers[slot].join();
+			write_block(data + block_offset(b),block_length(b,len),plans[slot]);
+
+			if (next < blocks) {
+				workers[slot] = std::thread(plan_block,data + block_offset(next),block_length(next,len),m_stream,&plans[slot]);
+				++next;
+			}
+		}
+
+		return true;
+	}
+
+	//Returns the mode that was written
+	uint32_t encode_block(const uint8_t* data,const uint32_t len) {
+		block_plan_t plan;
+
+		if (!m_stream)
+			return k_mode_end;
+
+		plan_block(data,len,m_stream,&plan);
+		write_block(data,len,plan);
+		return plan.mode;
+	}
+
+	void finish() {
+		if (!m_stream)
+			return;
+
+		m_stream->write(k_mode_end,k_mode_bits);
+		m_stream = 0;
+	}
+
+	private:
+	inline uint32_t block_offset(const uint32_t b) const {
+		return b * m_block_size;
+	}
+
+	inline uint32_t block_length(const uint32_t b,const uint32_t len) const {
+		const uint32_t left = len - block_offset(b);
+		return (left > m_block_size) ? m_block_size : left;
+	}
+
+	//Picks the cheapest mode , never writes (stream only backs the detached cost estimator)
+	static void plan_block(const uint8_t* data,const uint32_t len,bit_streams::bit_stream_writer_c<writer_type_c>* stream,block_plan_t* plan) {
+		max_range_type_t static_cost = k_no_cost,adaptive_cost = k_no_cost;
+		const max_range_type_t stored_cost = (max_range_type_t)len << (max_range_type_t)3;
+
+		for (uint32_t i = 0;i < k_symbols;++i)
+			plan->freqs[i] = 0;
+
+		for (uint32_t i = 0;i < len;++i)
+			++plan->freqs[data[i]];
+
+		if (len && table_t::normalize(plan->freqs,k_symbols,plan->norm))
+			static_cost = estimate_static(plan->freqs,plan->norm,len);
+
+		//Adaptive payload : estimate_cost() + the (2 + padding) flush bits
+		{
+			const max_range_type_t best = (static_cost < stored_cost) ? static_cost : stored_cost;
+
+			if (len && (k_max_bits < best)) {
+				coder_t coder;
+
+				if (coder.init(k_symbols,stream)) {
+					const max_range_type_t lim = best - k_max_bits;
+					const max_range_type_t tmp = coder.template estimate_cost<uint8_t>(data,len,lim);
+					if (tmp <= lim)
+						adaptive_cost = tmp + k_max_bits;
+				}
+
+				coder.detach();
+			}
+		}
+
+		max_range_type_t best = stored_cost;
+
+		plan->mode = k_mode_stored;
+		if (static_cost < best) {
+			plan->mode = k_mode_static;
+			best = static_cost;
+		}
+
+		if (adaptive_cost < best)
+			plan->mode = k_mode_adaptive;
+	}
+
+	void write_block(const uint8_t* data,const uint32_t len,const block_plan_t& plan) {
+		m_stream->write(plan.mode,k_mode_bits);
+		m_stream->write(len,k_length_bits);
+
+		switch (plan.mode) {
+			case k_mode_stored:
+				write_stored(data,len);
+			break;
+
+			case k_mode_static: {
+				static_coder_t coder;
+
+				write_static_header(plan.freqs,plan.norm);
+				coder.template init<probability_type_t>(plan.norm,len,k_symbols,m_stream);
+				for (uint32_t i = 0;i < len;++i)
+					coder.encode_symbol(data[i]);
+
+				coder.flush();
+			}
+			break;
+
+			case k_mode_adaptive: {
+				coder_t coder;
+
+				coder.init(k_symbols,m_stream);
+				for (uint32_t i = 0;i < len;++i)
+					coder.encode_symbol(data[i]);
+
+				coder.flush_padded();
+			}
+			break;
+		}
+	}
+
+	//log2(v) with k_log_frac_bits fraction bits (v <= 1 << k_static_log)
+	static uint64_t log2_fixed(const uint32_t v) {
+		const uint32_t ip = (uint32_t)table_t::floor_log2(v);
+		uint64_t x = (uint64_t)v << (uint64_t)(30U - ip);	//mantissa in [1,2) as 1.30
+		uint64_t r = (uint64_t)ip << (uint64_t)k_log_frac_bits;
+
+		for (uint32_t i = k_log_frac_bits;i--;) {
+			x = (x * x) >> (uint64_t)30;
+			if (x >= ((uint64_t)1 << (uint64_t)31)) {
+				x >>= (uint64_t)1;
+				r |= (uint64_t)1 << (uint64_t)i;
+			}
+		}
+
+		return r;
+	}
+
+	static uint32_t present_count(const uint32_t* freqs) {
+		uint32_t present = 0;
+
+		for (uint32_t i = 0;i < k_symbols;++i) {
+			if (freqs[i])
+				++present;
+		}
+
+		return present;
+	}
+
+	static uint32_t norm_width(const uint32_t* freqs,const probability_type_t* norm) {
+		uint32_t hi = 0,width = 0;
+
+		for (uint32_t i = 0;i < k_symbols;++i) {
+			if (freqs[i])
+				hi |= (uint32_t)norm[i] - 1U;
+		}
+
+		while (hi) {
+			++width;
+			hi >>= 1U;
+		}
+
+		return width;
+	}
+
+	static inline uint32_t symbols_bits(const uint32_t present) {
+		return ((present << 3U) < k_symbols) ? (present << 3U) : k_symbols;
+	}
+
+	static max_range_type_t estimate_static(const uint32_t* freqs,const probability_type_t* norm,const uint32_t len) {
+		const uint32_t present = present_count(freqs);
+		const uint64_t table_bits = (uint64_t)k_static_log << (uint64_t)k_log_frac_bits;
+		const uint64_t chunk = (uint64_t)table_t::k_block_size;
+		uint64_t cost = 0;
+
+		for (uint32_t i = 0;i < k_symbols;++i) {
+			if (freqs[i])
+				cost += (uint64_t)freqs[i] * (table_bits - log2_fixed((uint32_t)norm[i]));
+		}
+
+		cost >>= (uint64_t)k_log_frac_bits;
+		cost += ((((uint64_t)len + chunk - (uint64_t)1) / chunk) * (uint64_t)k_static_log);	//Initial state per tANS block
+		cost += 8U + symbols_bits(present) + k_width_bits + (present * norm_width(freqs,norm));
+		return (max_range_type_t)cost;
+	}
+
+	void write_static_header(const uint32_t* freqs,const probability_type_t* norm) {
+		const uint32_t present = present_count(freqs);
+		const uint32_t width = norm_width(freqs,norm);
+
+		m_stream->write(present - 1U,8U);
+		if (symbols_bits(present) < k_symbols) {
+			for (uint32_t i = 0;i < k_symbols;++i) {
+				if (freqs[i])
+					m_stream->write(i,8U);
+			}
+		} else {
+			for (uint32_t i = 0;i < k_symbols;++i)
+				m_stream->write(freqs[i] ? 1U : 0U,1U);
+		}
+
+		m_stream->write(width,k_width_bits);
+		if (width) {
+			for (uint32_t i = 0;i < k_symbols;++i) {
+				if (freqs[i])
+					m_stream->write((uint32_t)norm[i] - 1U,width);
+			}
+		}
+	}
+
+	void write_stored(const uint8_t* data,const uint32_t len) {
+		uint32_t i = 0;
+
+		for (;i + 8U <= len;i += 8U) {
+			uint64_t v = 0;
+			for (uint32_t j = 0;j < 8U;++j)
+				v = (v << (uint64_t)8) | (uint64_t)data[i + j];
+
+			m_stream->write(v,64U);
+		}
+
+		for (;i < len;++i)
+			m_stream->write(data[i],8U);
+	}
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef __scalable_block_adc_hpp__
+#define __scalable_block_adc_hpp__
+
+/*
+	Block level decoder for streams written by scalable_block_ac_c.
+
+	Stored blocks are copied straight out of the bitstream (64 bits per read) without touching a model.
+	Static blocks rebuild the tANS tables from the header's normalized frequencies.
+
+	Example usage :
+		bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> in; //requires my bitstreams lib
+		scalable_block_adc_c<file_streams::file_stream_reader_c,uint32_t,uint64_t> decoder;
+		uint32_t len;
+
+		in.open("in");
+		decoder.init(&in);
+
+		while (decoder.decode_block(buffer,capacity,len))
+			consume(buffer,len);
+
+		in.close();
+*/
+
+#include "scalable_adc.hpp"
+#include "scalable_tans_dec.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_block_adc_c {
+	public:
+	enum block_mode_e {
+		k_mode_stored = 0,
+		k_mode_static = 1,
+		k_mode_adaptive = 2,
+		k_mode_end = 3
+	};
+
+	static const uint32_t k_mode_bits = 2;
+	static const uint32_t k_length_bits = 32;
+	static const uint32_t k_width_bits = 4;
+	static const uint32_t k_symbols = 256;
+	static const uint32_t k_static_log = 12;
+
+	private:
+	typedef scalable_adc_c<reader_type_c,probability_type_t,max_range_type_t> decoder_t;
+	typedef scalable_tans_dec_c<reader_type_c,probability_type_t,max_range_type_t,k_static_log> static_decoder_t;
+
+	bit_streams::bit_stream_reader_c<reader_type_c>* m_stream;
+	uint32_t m_last_mode;
+
+	public:
+	scalable_block_adc_c() : m_stream(0),m_last_mode(k_mode_end) { }
+
+	bool init(bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if (!stream)
+			return false;
+
+		m_stream = stream;
+		return true;
+	}
+
+	inline uint32_t get_last_mode() const {
+		return m_last_mode;
+	}
+
+	//Returns false at the end marker or if the block does not fit in capacity
+	bool decode_block(uint8_t* out,const uint32_t capacity,uint32_t& len) {
+		len = 0;
+		if (!m_stream)
+			return false;
+
+		m_last_mode = (uint32_t)m_stream->read(k_mode_bits);
+		if (k_mode_end == m_last_mode) {
+			m_stream = 0;
+			return false;
+		}
+
+		len = (uint32_t)m_stream->read(k_length_bits);
+		if (len > capacity)
+			return false;
+
+		switch (m_last_mode) {
+			case k_mode_stored:
+				read_stored(out,len);
+			break;
+
+			case k_mode_static: {
+				uint32_t norm[k_symbols];
+				static_decoder_t decoder;
+
+				read_static_header(norm);
+				if (!decoder.template init<uint32_t>(norm,len,k_symbols,m_stream))
+					return false;
+
+				for (uint32_t i = 0;i < len;++i)
+					out[i] = (uint8_t)decoder.decode_symbol();
+			}
+			break;
+
+			case k_mode_adaptive: {
+				decoder_t decoder;
+
+				decoder.init(k_symbols,m_stream);
+				for (uint32_t i = 0;i < len;++i)
+					out[i] = (uint8_t)decoder.decode_symbol();
+			}
+			break;
+		}
+
+		return true;
+	}
+
+	private:
+	//See the static header layout in scalable_block_ac.hpp
+	void read_static_header(uint32_t* norm) {
+		const uint32_t present = (uint32_t)m_stream->read(8U) + 1U;
+		uint32_t width;
+
+		for (uint32_t i = 0;i < k_symbols;++i)
+			norm[i] = 0;
+
+		if ((present << 3U) < k_symbols) {
+			for (uint32_t i = 0;i < present;++i)
+				norm[(uint32_t)m_stream->read(8U)] = 1U;
+		} else {
+			for (uint32_t i = 0;i < k_symbols;++i)
+				norm[i] = (uint32_t)m_stream->read(1U);
+		}
+
+		width = (uint32_t)m_stream->read(k_width_bits);
+		for (uint32_t i = 0;i < k_symbols;++i) {
+			if (norm[i])
+				norm[i] += (width) ? (uint32_t)m_stream->read(width) : 0U;
+		}
+	}
+
+	void read_stored(uint8_t* out,const uint32_t len) {
+		uint32_t i = 0;
+
+		for (;i + 8U <= len;i += 8U) {
+			const uint64_t v = (uint64_t)m_stream->read(64U);
+			for (uint32_t j = 0;j < 8U;++j)
+				out[i + j] = (uint8_t)(v >> (uint64_t)((7U - j) << 3U));
+		}
+
+		for (;i < len;++i)
+			out[i] = (uint8_t)m_stream->read(8U);
+	}
+};
+
+#endif
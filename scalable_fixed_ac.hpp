@@ -0,0 +1,314 @@
+#ifndef __scalable_fixed_ac_hpp__
+#define __scalable_fixed_ac_hpp__
+
+/*
+	Fixed alphabet variant of scalable_ac_c.
+
+	The alphabet size is a template argument so the model lives inline in the coder (cache line aligned)
+	and every loop bound is a compile time constant. Construction, copies and save states never allocate,
+	so coders can live on the stack or in arrays.
+
+	The model is padded to whole chunks of k_lanes entries : updates add over whole chunks with constant
+	trip counts (so they vectorize) and scalable_fixed_adc_c finds symbols with a binary search.
+
+	A copy is detached (no stream , already flushed) : it can estimate_cost() from the current state but
+	never writes , so probing a copy can not disturb the original's output (encode_symbol() on a detached
+	coder only updates the model). Moves transfer the stream and detach the source , so coders can be
+	kept in growing containers such as std::vector.
+
+	The model evolves exactly like scalable_ac_c's : streams are interchangeable with scalable_ac_c /
+	scalable_adc_c / scalable_fixed_adc_c using the same types and alphabet size.
+
+	Example usage :
+		bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out; //requires my bitstreams lib
+		scalable_fixed_ac_c<file_streams::file_stream_writer_c,uint32_t,uint64_t,257> coder;
+
+		out.open("out");
+		coder.init(&out);
+
+		for (i = 0;i < len;++i)
+			coder.encode_symbol(buffer[i]);
+
+		coder.encode_symbol(256); // eof
+		coder.flush();
+		out.close();
+
+	Example usage of copies :
+		scalable_fixed_ac_c<...> probe = coder;
+		cost = probe.estimate_cost<uint8_t>(buffer,len,bit_limit);
+
+	Example usage of save states :
+		scalable_fixed_ac_c<...>::scalable_ac_state_t state;
+
+		coder.save_state(state);
+		cost = coder.estimate_cost<uint8_t>(buffer,len,bit_limit);
+		coder.restore_state(state);
+*/
+
+#include "scalable_range_enc.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t,max_range_type_t max_symbols>
+class scalable_fixed_ac_c : public scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> range_t;
+
+	public:
+	struct scalable_ac_state_t {
+		alignas(64) probability_type_t probability[max_symbols + 1];
+		max_range_type_t high,low,underflow_count;
+		max_range_type_t tmp_range;
+		bool flushed;
+	};
+
+	private:
+	static const max_range_type_t k_max_syms = max_symbols;
+	static const max_range_type_t k_lanes = 16;
+	static const max_range_type_t k_model_size = (max_symbols + k_lanes) & ~(k_lanes - (max_range_type_t)1);	//max_symbols + 1 rounded up to whole chunks
+
+	using range_t::k_max_range;
+	using range_t::m_stream;
+	using range_t::m_high;
+	using range_t::m_low;
+	using range_t::m_underflow_count;
+	using range_t::m_tmp_range;
+	using range_t::m_bits_written;
+	using range_t::m_flushed;
+	using range_t::reset_range;
+	using range_t::finish_range;
+	using range_t::pad_range;
+	using range_t::range_code_interval;
+
+	static_assert(max_symbols > 0,"scalable_fixed_ac_c : empty alphabet");
+	static_assert(max_symbols < k_max_range,"scalable_fixed_ac_c : alphabet does not fit the probability range");
+
+	alignas(64) probability_type_t m_probability[k_model_size];
+
+	public:
+	scalable_fixed_ac_c() {
+		reset_model();
+	}
+
+	scalable_fixed_ac_c(const scalable_fixed_ac_c& other) {
+		copy_detached(other);
+	}
+
+	scalable_fixed_ac_c& operator=(const scalable_fixed_ac_c& other) {
+		if (this != &other) {
+			flush();
+			copy_detached(other);
+		}
+
+		return *this;
+	}
+
+	scalable_fixed_ac_c(scalable_fixed_ac_c&& other) noexcept {
+		move_from(other);
+	}
+
+	scalable_fixed_ac_c& operator=(scalable_fixed_ac_c&& other) noexcept {
+		if (this != &other) {
+			flush();
+			move_from(other);
+		}
+
+		return *this;
+	}
+
+	~scalable_fixed_ac_c() {
+		flush();
+	}
+
+	void save_state(scalable_ac_state_t& state) const {
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			state.probability[i] = m_probability[i];
+
+		state.high = m_high;
+		state.low = m_low;
+		state.underflow_count = m_underflow_count;
+		state.flushed = m_flushed;
+		state.tmp_range = m_tmp_range;
+	}
+
+	void restore_state(const scalable_ac_state_t& state) {
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			m_probability[i] = state.probability[i];
+
+		m_high = state.high;
+		m_low = state.low;
+		m_underflow_count = state.underflow_count;
+		m_flushed = state.flushed;
+		m_tmp_range = state.tmp_range;
+	}
+
+	inline probability_type_t* get_model() {
+		return m_probability;
+	}
+
+	bool flush(const bool force = false) {
+		if (!m_stream)
+			return false;
+
+		if ((!m_flushed) || force)
+			finish_range();
+
+		return false;
+	}
+
+	//See scalable_ac_c::flush_padded()
+	bool flush_padded() {
+		if ((!m_stream) || (m_flushed))
+			return false;
+
+		flush();
+		pad_range();
+		return true;
+	}
+
+	inline void detach() {
+		m_stream = 0;
+		m_flushed = true;
+	}
+
+	//Starts a new message from a pre-trained model (see scalable_prototype.hpp)
+	bool reset(const probability_type_t* model,bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		flush();
+		if ((!stream) || (!model))
+			return false;
+
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			m_probability[i] = model[i];
+
+		reset_range(stream);
+		return true;
+	}
+
+	bool init(bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		flush();
+		if (!stream)
+			return false;
+
+		reset_range(stream);
+		reset_model();
+		return true;
+	}
+
+	//Initialize from static prob symbol table
+	template <typename base_t>
+	bool init(const base_t* symbol_real_frequencies,const max_range_type_t count,bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		flush();
+		if (!stream)
+			return false;
+
+		reset_range(stream);
+
+		m_probability[0] = 0;
+		if (count >= k_max_range) {
+			const max_range_type_t lim = (count / k_max_range) + 1;
+			for (max_range_type_t i=(max_range_type_t)0;i < k_max_syms;i++) {
+				max_range_type_t tmp = symbol_real_frequencies[i];
+				if (tmp > lim)
+					tmp /= lim;
+				else if (tmp)
+					tmp = 1;
+
+				m_probability[i+1] = tmp;
+			}
+		} else {
+			for (max_range_type_t i=(max_range_type_t)0;i < k_max_syms;i++)
+				m_probability[i+1] = symbol_real_frequencies[i];
+		}
+
+		for (max_range_type_t i=(max_range_type_t)1;i <= k_max_syms;i++)
+			m_probability[i] +=m_probability[i-1];
+
+		return true;
+	}
+
+	inline void encode_symbol(const max_range_type_t s) {
+		range_code(s,!m_stream);
+		update_model(s);
+	}
+
+	//Remember to save/restore states!
+	template <typename base_t>
+	const max_range_type_t estimate_cost(const base_t s) {
+		const max_range_type_t cost = range_code(s,true);
+		update_model(s);
+		return cost;
+	}
+
+	//Remember to save/restore states!
+	template <typename base_t>
+	const max_range_type_t estimate_cost(const base_t* s,const max_range_type_t count,const max_range_type_t lim = (max_range_type_t)-1) {
+		max_range_type_t cost = 0;
+		for (max_range_type_t i = 0;i < count;++i) {
+			cost += estimate_cost(*(s++));
+			if (cost > lim)
+				break;
+		}
+
+		return cost;
+	}
+
+	private:
+	void copy_detached(const scalable_fixed_ac_c& other) {
+		for (max_range_type_t i = 0;i < k_model_size;++i)
+			m_probability[i] = other.m_probability[i];
+
+		m_high = other.m_high;
+		m_low = other.m_low;
+		m_underflow_count = other.m_underflow_count;
+		m_tmp_range = other.m_tmp_range;
+		m_bits_written = other.m_bits_written;
+		m_stream = 0;
+		m_flushed = true;
+	}
+
+	void move_from(scalable_fixed_ac_c& other) {
+		copy_detached(other);
+		m_stream = other.m_stream;
+		m_flushed = other.m_flushed;
+		other.detach();
+	}
+
+	inline void reset_model() {
+		for (max_range_type_t i = 0;i < k_model_size;++i)
+			m_probability[i] = (probability_type_t)i;
+	}
+
+	inline void update_model(const max_range_type_t s) {
+		//Whole k_lanes chunks from the one holding s + 1 : the first one masked , constant trip counts vectorize
+		max_range_type_t c = (s + (max_range_type_t)1) & ~(k_lanes - (max_range_type_t)1);
+		const probability_type_t sp = (probability_type_t)s;
+
+		for (probability_type_t i = 0;i < (probability_type_t)k_lanes;++i)
+			m_probability[c + i] += (probability_type_t)((probability_type_t)(c + i) > sp);
+
+		for (c += k_lanes;c < k_model_size;c += k_lanes) {
+			for (probability_type_t i = 0;i < (probability_type_t)k_lanes;++i)
+				m_probability[c + i] += (probability_type_t)1U;
+		}
+
+		if (m_probability[k_max_syms] >= k_max_range)
+			scale_model();
+	}
+
+	void scale_model() {
+		probability_type_t prev = m_probability[0],curr;
+
+		for (max_range_type_t i = 1;i <= k_max_syms;++i) {
+			curr = m_probability[i] >> (probability_type_t)1;
+			if (curr <= prev)
+				curr = prev + (probability_type_t)1;
+
+			m_probability[i] = curr;
+			prev = curr;
+		}
+	}
+
+	inline max_range_type_t range_code(max_range_type_t symbol,const bool simulate = false) {
+		return range_code_interval((max_range_type_t)m_probability[symbol],(max_range_type_t)m_probability[symbol + (max_range_type_t)1],
+									(max_range_type_t)m_probability[k_max_syms],simulate);
+	}
+};
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef __scalable_fixed_adc_hpp__
+#define __scalable_fixed_adc_hpp__
+
+/*
+	Fixed alphabet variant of scalable_adc_c (see scalable_fixed_ac.hpp).
+
+	Example usage :
+		bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> in; //requires my bitstreams lib
+		scalable_fixed_adc_c<file_streams::file_stream_reader_c,uint32_t,uint64_t,257> decoder;
+
+		in.open("in");
+		decoder.init(&in);
+
+		while ((symbol = decoder.decode_symbol()) != 256)
+			std :: cout << symbol << std::endl;
+
+		in.close();
+*/
+
+#include "scalable_range_dec.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t,max_range_type_t max_symbols>
+class scalable_fixed_adc_c : public scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> range_t;
+
+	public:
+	struct scalable_adc_state_t {
+		alignas(64) probability_type_t probability[max_symbols + 1];
+		max_range_type_t high,low;
+		max_range_type_t tmp_range;
+		max_range_type_t code;
+	};
+
+	private:
+	static const max_range_type_t k_max_syms = max_symbols;
+	static const max_range_type_t k_lanes = 16;
+	static const max_range_type_t k_model_size = (max_symbols + k_lanes) & ~(k_lanes - (max_range_type_t)1);	//See scalable_fixed_ac_c
+
+	using range_t::k_max_range;
+	using range_t::m_high;
+	using range_t::m_low;
+	using range_t::m_tmp_range;
+	using range_t::m_code;
+	using range_t::reset_range;
+	using range_t::get_current_prob;
+	using range_t::remove_range_interval;
+
+	static_assert(max_symbols > 0,"scalable_fixed_adc_c : empty alphabet");
+	static_assert(max_symbols < k_max_range,"scalable_fixed_adc_c : alphabet does not fit the probability range");
+
+	alignas(64) probability_type_t m_probability[k_model_size];
+
+	public:
+	scalable_fixed_adc_c() {
+		reset_model();
+	}
+
+	inline probability_type_t* get_model() {
+		return m_probability;
+	}
+
+	void save_state(scalable_adc_state_t& state) const {
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			state.probability[i] = m_probability[i];
+
+		state.high = m_high;
+		state.low = m_low;
+		state.code = m_code;
+		state.tmp_range = m_tmp_range;
+	}
+
+	void restore_state(const scalable_adc_state_t& state) {
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			m_probability[i] = state.probability[i];
+
+		m_high = state.high;
+		m_low = state.low;
+		m_code = state.code;
+		m_tmp_range = state.tmp_range;
+	}
+
+	max_range_type_t decode_symbol() {
+		const max_range_type_t prob = get_current_prob(m_probability[k_max_syms]);
+		max_range_type_t sym = 0;
+		max_range_type_t step = 1;
+
+		//Last symbol whose low bound is <= prob (same result as a backward scan) , the step count is a compile time constant
+		while ((step << (max_range_type_t)1) < k_max_syms)
+			step <<= (max_range_type_t)1;
+
+		for (;step;step >>= (max_range_type_t)1) {
+			const max_range_type_t next = sym + step;
+			if ((next < k_max_syms) && ((max_range_type_t)m_probability[next] <= prob))
+				sym = next;
+		}
+
+		remove_range(sym);
+		update_model(sym);
+		return sym;
+	}
+
+	//Counterpart of scalable_fixed_ac_c::reset()
+	bool reset(const probability_type_t* model,bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if ((!stream) || (!model))
+			return false;
+
+		for (max_range_type_t i = 0;i <= k_max_syms;++i)
+			m_probability[i] = model[i];
+
+		reset_range(stream);
+		return true;
+	}
+
+	bool init(bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if (!stream)
+			return false;
+
+		reset_model();
+		reset_range(stream);
+		return true;
+	}
+
+	//Initialize from static prob symbol table
+	template <typename base_t>
+	bool init(const base_t* symbol_real_frequencies,const max_range_type_t count,bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if (!stream)
+			return false;
+
+		m_probability[0] = 0;
+		if (count >= k_max_range) {
+			const max_range_type_t lim = (count / k_max_range) + 1;
+			for (max_range_type_t i=(max_range_type_t)0;i < k_max_syms;i++) {
+				max_range_type_t tmp = symbol_real_frequencies[i];
+				if (tmp > lim)
+					tmp /= lim;
+				else if (tmp)
+					tmp = 1;
+
+				m_probability[i+1] = tmp;
+			}
+		} else {
+			for (max_range_type_t i=(max_range_type_t)0;i < k_max_syms;i++)
+				m_probability[i+1] = symbol_real_frequencies[i];
+		}
+
+		for (max_range_type_t i=(max_range_type_t)1;i <= k_max_syms;i++)
+			m_probability[i] +=m_probability[i-1];
+
+		reset_range(stream);
+		return true;
+	}
+
+	private:
+	inline void reset_model() {
+		for (max_range_type_t i = 0;i < k_model_size;++i)
+			m_probability[i] = (probability_type_t)i;
+	}
+
+	//Mirrors scalable_fixed_ac_c::update_model()
+	inline void update_model(const max_range_type_t s) {
+		max_range_type_t c = (s + (max_range_type_t)1) & ~(k_lanes - (max_range_type_t)1);
+		const probability_type_t sp = (probability_type_t)s;
+
+		for (probability_type_t i = 0;i < (probability_type_t)k_lanes;++i)
+			m_probability[c + i] += (probability_type_t)((probability_type_t)(c + i) > sp);
+
+		for (c += k_lanes;c < k_model_size;c += k_lanes) {
+			for (probability_type_t i = 0;i < (probability_type_t)k_lanes;++i)
+				m_probability[c + i] += (probability_type_t)1U;
+		}
+
+		if (m_probability[k_max_syms] >= k_max_range)
+			scale_model();
+	}
+
+	void scale_model() {
+		probability_type_t prev = m_probability[0],curr;
+
+		for (max_range_type_t i = 1;i <= k_max_syms;++i) {
+			curr = m_probability[i] >> (probability_type_t)1;
+			if (curr <= prev)
+				curr = prev + (probability_type_t)1;
+
+			m_probability[i] = curr;
+			prev = curr;
+		}
+	}
+
+	inline void remove_range(max_range_type_t symbol) {
+		remove_range_interval((max_range_type_t)m_probability[symbol],(max_range_type_t)m_probability[symbol + (max_range_type_t)1],
+								(max_range_type_t)m_probability[k_max_syms]);
+	}
+};
+
+#endif
@@ -0,0 +1,437 @@
+#ifndef __scalable_pipeline_hpp__
+#define __scalable_pipeline_hpp__
+
+/*
+	Pipelined I/O for the scalable coders.
+
+	scalable_async_reader_c / scalable_async_writer_c move file reads and writes to their own thread.
+	Data is exchanged through a ring of fixed size blocks (scalable_block_ring_c) so memory use is bounded
+	and a stalled side applies backpressure to the other.
+
+	bit_streams::bit_stream_writer_c / bit_stream_reader_c are specialized for them, so the coders run
+	unchanged on top : the coding thread only ever touches memory.
+	Bits are packed MSB first ; streams written this way must be read back the same way.
+
+	Example usage :
+		scalable_async_writer_c sink;
+		bit_streams::bit_stream_writer_c<scalable_async_writer_c> out;
+		scalable_ac_c<scalable_async_writer_c,uint32_t,uint64_t> coder;
+
+		sink.open("out");
+		out.open(&sink);
+		coder.init(256 + 1,&out);
+
+		... encode ...
+
+		coder.flush();
+		out.close();
+		sink.close();
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "bit_streams.hpp"
+
+class scalable_block_ring_c {
+	public:
+	struct block_t {
+		uint8_t* data;
+		uint32_t size;
+	};
+
+	private:
+	std::mutex m_lock;
+	std::condition_variable m_cond;
+	block_t* m_blocks;
+	uint32_t m_count;
+	uint32_t m_block_size;
+	uint64_t m_produced,m_consumed;
+	bool m_finished,m_cancelled;
+
+	public:
+	scalable_block_ring_c() : m_blocks(0),m_count(0),m_block_size(0),m_produced(0),m_consumed(0),
+	m_finished(false),m_cancelled(false) { }
+
+	~scalable_block_ring_c() {
+		release_blocks();
+	}
+
+	bool init(const uint32_t count,const uint32_t block_size) {
+		release_blocks();
+		if ((!count) || (!block_size))
+			return false;
+
+		m_blocks = new block_t[count];
+		if (!m_blocks)
+			return false;
+
+		for (uint32_t i = 0;i < count;++i) {
+			m_blocks[i].data = new uint8_t[block_size];
+			m_blocks[i].size = 0;
+			if (!m_blocks[i].data) {
+				m_count = i;
+				release_blocks();
+				return false;
+			}
+		}
+
+		m_count = count;
+		m_block_size = block_size;
+		m_produced = 0;
+		m_consumed = 0;
+		m_finished = false;
+		m_cancelled = false;
+		return true;
+	}
+
+	inline uint32_t block_size() const {
+		return m_block_size;
+	}
+
+	//Producer side : waits while every block is in flight , 0 once cancelled
+	block_t* acquire_free() {
+		std::unique_lock<std::mutex> guard(m_lock);
+
+		m_cond.wait(guard,[this] { return m_cancelled || (m_produced - m_consumed < m_count); });
+		if (m_cancelled)
+			return 0;
+
+		block_t* block = &m_blocks[m_produced % m_count];
+		block->size = 0;
+		return block;
+	}
+
+	void commit() {
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			++m_produced;
+		}
+
+		m_cond.notify_all();
+	}
+
+	void finish() {
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			m_finished = true;
+		}
+
+		m_cond.notify_all();
+	}
+
+	//Consumer side : waits for data , 0 once the producer finished and the ring is drained
+	block_t* acquire_full() {
+		std::unique_lock<std::mutex> guard(m_lock);
+
+		m_cond.wait(guard,[this] { return m_cancelled || m_finished || (m_produced != m_consumed); });
+		if ((m_cancelled) || (m_produced == m_consumed))
+			return 0;
+
+		return &m_blocks[m_consumed % m_count];
+	}
+
+	void release() {
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			++m_consumed;
+		}
+
+		m_cond.notify_all();
+	}
+
+	void cancel() {
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			m_cancelled = true;
+		}
+
+		m_cond.notify_all();
+	}
+
+	private:
+	void release_blocks() {
+		for (uint32_t i = 0;i < m_count;++i)
+			delete[] m_blocks[i].data;
+
+		delete[] m_blocks;
+		m_blocks = 0;
+		m_count = 0;
+	}
+};
+
+class scalable_async_reader_c {
+	public:
+	static const uint32_t k_default_blocks = 4;
+	static const uint32_t k_default_block_size = 1U << 16U;
+
+	private:
+	scalable_block_ring_c m_ring;
+	std::thread m_thread;
+	file_streams::file_stream_if* m_file;
+	scalable_block_ring_c::block_t* m_block;
+	uint32_t m_pos;
+	uint32_t m_size;
+	bool m_eof;
+
+	public:
+	scalable_async_reader_c() : m_file(0),m_block(0),m_pos(0),m_size(0),m_eof(true) { }
+
+	~scalable_async_reader_c() {
+		close();
+	}
+
+	bool open(const char* file,const uint32_t blocks = k_default_blocks,const uint32_t block_size = k_default_block_size) {
+		close();
+		if (!m_ring.init(blocks,block_size))
+			return false;
+
+		m_file = new file_streams::file_stream_reader_c(file);
+		if (!m_file)
+			return false;
+
+		m_size = m_file->size();
+		m_block = 0;
+		m_pos = 0;
+		m_eof = false;
+		m_thread = std::thread(&scalable_async_reader_c::run,this);
+		return true;
+	}
+
+	void close() {
+		if (!m_file)
+			return;
+
+		m_ring.cancel();
+		m_thread.join();
+		delete m_file;
+		m_file = 0;
+		m_block = 0;
+		m_eof = true;
+	}
+
+	inline uint32_t size() const {
+		return m_size;
+	}
+
+	inline bool eof() {
+		return (m_eof) || ((!m_block || (m_pos == m_block->size)) && (!next_block()));
+	}
+
+	//0 past the end of the file
+	inline uint8_t read() {
+		if ((!m_block) || (m_pos == m_block->size)) {
+			if (!next_block())
+				return 0;
+		}
+
+		return m_block->data[m_pos++];
+	}
+
+	private:
+	bool next_block() {
+		if (m_eof)
+			return false;
+
+		if (m_block)
+			m_ring.release();
+
+		m_pos = 0;
+		m_block = m_ring.acquire_full();
+		if (!m_block) {
+			m_eof = true;
+			return false;
+		}
+
+		return true;
+	}
+
+	void run() {
+		const uint32_t block_size = m_ring.block_size();
+
+		for (uint32_t left = m_size;left;) {
+			scalable_block_ring_c::block_t* block = m_ring.acquire_free();
+			if (!block)
+				return;
+
+			const uint32_t len = (left > block_size) ? block_size : left;
+			for (uint32_t i = 0;i < len;++i)
+				block->data[i] = (uint8_t)m_file->read();
+
+			block->size = len;
+			left -= len;
+			m_ring.commit();
+		}
+
+		m_ring.finish();
+	}
+};
+
+class scalable_async_writer_c {
+	public:
+	static const uint32_t k_default_blocks = 4;
+	static const uint32_t k_default_block_size = 1U << 16U;
+
+	private:
+	scalable_block_ring_c m_ring;
+	std::thread m_thread;
+	file_streams::file_stream_if* m_file;
+	scalable_block_ring_c::block_t* m_block;
+	uint32_t m_block_size;
+
+	public:
+	scalable_async_writer_c() : m_file(0),m_block(0),m_block_size(0) { }
+
+	~scalable_async_writer_c() {
+		close();
+	}
+
+	bool open(const char* file,const uint32_t blocks = k_default_blocks,const uint32_t block_size = k_default_block_size) {
+		close();
+		if (!m_ring.init(blocks,block_size))
+			return false;
+
+		m_file = new file_streams::file_stream_writer_c(file);
+		if (!m_file)
+			return false;
+
+		m_block_size = block_size;
+		m_thread = std::thread(&scalable_async_writer_c::run,this);
+		m_block = m_ring.acquire_free();
+		return true;
+	}
+
+	//Commits the pending block and waits for the writer thread to drain the ring
+	void close() {
+		if (!m_file)
+			return;
+
+		if ((m_block) && (m_block->size))
+			m_ring.commit();
+
+		m_ring.finish();
+		m_thread.join();
+		delete m_file;
+		m_file = 0;
+		m_block = 0;
+	}
+
+	inline void write(const uint8_t v) {
+		m_block->data[m_block->size] = v;
+		if (++m_block->size == m_block_size) {
+			m_ring.commit();
+			m_block = m_ring.acquire_free();
+		}
+	}
+
+	private:
+	void run() {
+		scalable_block_ring_c::block_t* block;
+
+		while (0 != (block = m_ring.acquire_full())) {
+			for (uint32_t i = 0;i < block->size;++i)
+				m_file->write(block->data[i]);
+
+			m_ring.release();
+		}
+	}
+};
+
+namespace bit_streams {
+	template <>
+	class bit_stream_writer_c<scalable_async_writer_c> {
+		private:
+		scalable_async_writer_c* m_sink;
+		uint32_t m_acc;
+		uint32_t m_count;
+
+		public:
+		bit_stream_writer_c() : m_sink(0),m_acc(0),m_count(0) { }
+
+		~bit_stream_writer_c() {
+			close();
+		}
+
+		bool open(scalable_async_writer_c* sink) {
+			close();
+			m_sink = sink;
+			m_acc = 0;
+			m_count = 0;
+			return (0 != sink);
+		}
+
+		//Pads the last byte with zeros
+		void close() {
+			if (!m_sink)
+				return;
+
+			if (m_count)
+				m_sink->write((uint8_t)(m_acc << (8U - m_count)));
+
+			m_sink = 0;
+			m_count = 0;
+		}
+
+		inline void write(const uint64_t v,uint32_t bits) {
+			while (bits) {
+				const uint32_t room = 8U - m_count;
+				const uint32_t take = (bits < room) ? bits : room;
+
+				bits -= take;
+				m_acc = (m_acc << take) | (uint32_t)((v >> (uint64_t)bits) & (((uint64_t)1 << (uint64_t)take) - (uint64_t)1));
+				m_count += take;
+
+				if (8U == m_count) {
+					m_sink->write((uint8_t)m_acc);
+					m_acc = 0;
+					m_count = 0;
+				}
+			}
+		}
+	};
+
+	template <>
+	class bit_stream_reader_c<scalable_async_reader_c> {
+		private:
+		scalable_async_reader_c* m_source;
+		uint32_t m_acc;
+		uint32_t m_count;
+
+		public:
+		bit_stream_reader_c() : m_source(0),m_acc(0),m_count(0) { }
+
+		bool open(scalable_async_reader_c* source) {
+			m_source = source;
+			m_acc = 0;
+			m_count = 0;
+			return (0 != source);
+		}
+
+		void close() {
+			m_source = 0;
+			m_count = 0;
+		}
+
+		//Zeros past the end of the stream
+		inline uint64_t read(uint32_t bits) {
+			uint64_t v = 0;
+
+			while (bits) {
+				if (!m_count) {
+					m_acc = m_source->read();
+					m_count = 8U;
+				}
+
+				const uint32_t take = (bits < m_count) ? bits : m_count;
+
+				m_count -= take;
+				bits -= take;
+				v = (v << (uint64_t)take) | (uint64_t)((m_acc >> m_count) & ((1U << take) - 1U));
+			}
+
+			return v;
+		}
+	};
+}
+
+#endif
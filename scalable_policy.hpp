@@ -0,0 +1,132 @@
+#ifndef __scalable_policy_hpp__
+#define __scalable_policy_hpp__
+
+/*
+	Adaptation policies for scalable_ac_c / scalable_adc_c.
+
+	A policy decides how the adaptive model learns :
+		state_t			: per coder state (saved with save_state())
+		init(state)		: called on init() / reset()
+		increment(state): added to the cumulative model for every coded symbol
+		limit(k_max_range)	: rescale threshold for the model total (must not exceed k_max_range)
+		rescale(state,model,max_syms,limit) : called once the total reaches limit , must bring it back below
+
+	Encoder and decoder must use the same policy.
+
+	Example usage :
+		//Adapt faster : increments of 8 , rescale at 1/4 of the range and keep 3/4 of every frequency
+		typedef scalable_tuned_policy_c<8,8,2,2> fast_policy_t;
+
+		scalable_ac_c<file_streams::file_stream_writer_c,uint16_t,uint32_t,fast_policy_t> coder;
+		scalable_adc_c<file_streams::file_stream_reader_c,uint16_t,uint32_t,fast_policy_t> decoder;
+*/
+
+#include <stdint.h>
+
+//+1 per symbol , halve the cumulative table at k_max_range (the original scalable_ac_c behaviour)
+struct scalable_default_policy_c {
+	struct state_t { };
+
+	static inline void init(state_t&) { }
+
+	static inline uint32_t increment(const state_t&) {
+		return 1U;
+	}
+
+	template <typename max_range_type_t>
+	static inline max_range_type_t limit(const max_range_type_t max_range) {
+		return max_range;
+	}
+
+	template <typename probability_type_t,typename max_range_type_t>
+	static void rescale(state_t&,probability_type_t* probability,const max_range_type_t max_syms,const max_range_type_t) {
+		register probability_type_t* p0 = &probability[(max_range_type_t)0];
+		register probability_type_t* p1 = &probability[(max_range_type_t)max_syms + (max_range_type_t)1];
+		register probability_type_t prev = *(p0++),curr;
+		if (p0 >= p1)
+			return;
+
+		do {
+			curr = *(p0) >> (probability_type_t)1;
+			if (curr <= prev)
+				curr = prev + (probability_type_t)1;
+
+			*(p0++) = curr;
+			prev = curr;
+		} while (p0 < p1);
+	}
+};
+
+/*
+	increment_init		: increment used from init()
+	increment_final		: the increment doubles (or halves) on every rescale until it reaches this one
+	limit_shift			: rescale once the total reaches k_max_range >> limit_shift
+	decay_shift			: every frequency f becomes f - (f >> decay_shift) on rescale (at least 1) ,
+						  frequencies are then halved while the total is still above the limit
+*/
+template <uint32_t increment_init = 1U,uint32_t increment_final = 1U,uint32_t limit_shift = 0U,uint32_t decay_shift = 1U>
+struct scalable_tuned_policy_c {
+	struct state_t {
+		uint32_t increment;
+	};
+
+	static_assert((increment_init > 0U) && (increment_final > 0U),"scalable_tuned_policy_c : zero increment");
+	static_assert(decay_shift > 0U,"scalable_tuned_policy_c : decay_shift 0 would drop the whole model");
+
+	static inline void init(state_t& state) {
+		state.increment = increment_init;
+	}
+
+	static inline uint32_t increment(const state_t& state) {
+		return state.increment;
+	}
+
+	template <typename max_range_type_t>
+	static inline max_range_type_t limit(const max_range_type_t max_range) {
+		return max_range >> (max_range_type_t)limit_shift;
+	}
+
+	template <typename probability_type_t,typename max_range_type_t>
+	static void rescale(state_t& state,probability_type_t* probability,const max_range_type_t max_syms,const max_range_type_t limit) {
+		static_assert(decay_shift < (sizeof(probability_type_t) << 3U),"scalable_tuned_policy_c : decay_shift exceeds the probability width");
+		static_assert(((uint64_t)increment_init <= ((uint64_t)1 << ((sizeof(probability_type_t) << 3U) - 2U)) - 1U) &&
+					((uint64_t)increment_final <= ((uint64_t)1 << ((sizeof(probability_type_t) << 3U) - 2U)) - 1U),
+					"scalable_tuned_policy_c : increment does not fit the probability range");
+
+		decay(probability,max_syms,(probability_type_t)decay_shift);
+
+		//Frequencies below 1 << decay_shift do not decay at all : halve until the total is back below limit
+		while (((max_range_type_t)probability[max_syms] >= limit) && ((max_range_type_t)probability[max_syms] > max_syms))
+			decay(probability,max_syms,(probability_type_t)1);
+
+		if (state.increment < increment_final) {
+			state.increment <<= 1U;
+			if (state.increment > increment_final)
+				state.increment = increment_final;
+		} else if (state.increment > increment_final) {
+			state.increment >>= 1U;
+			if (state.increment < increment_final)
+				state.increment = increment_final;
+		}
+	}
+
+	private:
+	template <typename probability_type_t,typename max_range_type_t>
+	static void decay(probability_type_t* probability,const max_range_type_t max_syms,const probability_type_t shift) {
+		probability_type_t prev_old = probability[0],prev_new = probability[0];
+
+		for (max_range_type_t i = 1;i <= max_syms;++i) {
+			probability_type_t f = probability[i] - prev_old;
+
+			prev_old = probability[i];
+			f -= f >> shift;
+			if (!f)
+				f = 1;
+
+			prev_new += f;
+			probability[i] = prev_new;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef __scalable_prototype_hpp__
+#define __scalable_prototype_hpp__
+
+/*
+	Pre-trained (prototype) models for coding many small messages.
+
+	A prototype is trained offline from sample data, frozen into a cumulative table in the coders'
+	layout and serialized. Per message the coders are then reset() from it : the model is copied into
+	storage they already own and coding starts from trained statistics instead of a uniform model.
+
+	max_total bounds the trained table total : larger totals trust the prototype longer, smaller ones
+	let each message adapt away from it faster. It must stay below the coders' rescale limit.
+
+	Serialized layout :
+		32 bits max_syms | 6 bits width | max_syms x width bits frequencies
+
+	Example usage :
+		scalable_prototype_c<uint32_t,uint64_t> proto;
+
+		proto.init(256);
+		for (each sample)
+			proto.train<uint8_t>(sample,sample_len);
+
+		proto.build();
+
+		for (each message) {
+			coder.reset(proto.get_model(),256,&out);
+			...
+			coder.flush();
+		}
+*/
+
+#include "bit_streams.hpp"
+
+template <typename probability_type_t,typename max_range_type_t>
+class scalable_prototype_c {
+	public:
+	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
+	static const max_range_type_t k_max_range = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
+	static const max_range_type_t k_default_max_total = k_max_range >> (max_range_type_t)4;
+	static const uint32_t k_width_bits = 6;
+
+	private:
+	uint64_t* m_counts;
+	probability_type_t* m_probability;
+	max_range_type_t m_max_syms;
+
+	public:
+	scalable_prototype_c() : m_counts(0),m_probability(0),m_max_syms(0) { }
+
+	~scalable_prototype_c() {
+		release();
+	}
+
+	bool init(const max_range_type_t max_symbols) {
+		release();
+		if ((!max_symbols) || (max_symbols >= (k_max_range >> (max_range_type_t)1)))
+			return false;
+
+		m_counts = new uint64_t[max_symbols];
+		m_probability = new probability_type_t[max_symbols + 1];
+		if ((!m_counts) || (!m_probability)) {
+			release();
+			return false;
+		}
+
+		m_max_syms = max_symbols;
+		for (max_range_type_t i = 0;i < max_symbols;++i)
+			m_counts[i] = 0;
+
+		for (max_range_type_t i = 0;i <= max_symbols;++i)
+			m_probability[i] = (probability_type_t)i;
+
+		return true;
+	}
+
+	template <typename base_t>
+	void train(const base_t* s,const max_range_type_t count) {
+		for (max_range_type_t i = 0;i < count;++i)
+			++m_counts[(max_range_type_t)s[i]];
+	}
+
+	//Freezes the counts into a cumulative table , every symbol keeps a non zero frequency
+	bool build(max_range_type_t max_total = k_default_max_total) {
+		uint64_t total = 0;
+
+		if (!m_probability)
+			return false;
+
+		if (max_total < m_max_syms)
+			max_total = m_max_syms;
+
+		if (max_total >= k_max_range)
+			max_total = k_max_range - (max_range_type_t)1;
+
+		for (max_range_type_t i = 0;i < m_max_syms;++i)
+			total += m_counts[i];
+
+		//Leave room for the +1 floor of every symbol
+		const uint64_t budget = (uint64_t)(max_total - m_max_syms);
+
+		m_probability[0] = 0;
+		for (max_range_type_t i = 0;i < m_max_syms;++i) {
+			uint64_t f = m_counts[i];
+
+			if (total > budget)
+				f = (f * budget) / total;
+
+			m_probability[i + 1] = m_probability[i] + (probability_type_t)(f + (uint64_t)1);
+		}
+
+		return true;
+	}
+
+	inline const probability_type_t* get_model() const {
+		return m_probability;
+	}
+
+	inline max_range_type_t get_max_symbols() const {
+		return m_max_syms;
+	}
+
+	template <class writer_type_c>
+	bool write(bit_streams::bit_stream_writer_c<writer_type_c>* stream) const {
+		max_range_type_t hi = 0;
+		uint32_t width = 0;
+
+		if ((!stream) || (!m_probability))
+			return false;
+
+		for (max_range_type_t i = 1;i <= m_max_syms;++i)
+			hi |= (max_range_type_t)(m_probability[i] - m_probability[i - 1]);
+
+		for (;hi;hi >>= (max_range_type_t)1)
+			++width;
+
+		stream->write(m_max_syms,32);
+		stream->write(width,k_width_bits);
+		for (max_range_type_t i = 1;i <= m_max_syms;++i)
+			stream->write(m_probability[i] - m_probability[i - 1],width);
+
+		return true;
+	}
+
+	template <class reader_type_c>
+	bool read(bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if (!stream)
+			return false;
+
+		if (!init((max_range_type_t)stream->read(32)))
+			return false;
+
+		const uint32_t width = (uint32_t)stream->read(k_width_bits);
+		if (!width) {
+			release();
+			return false;
+		}
+
+		m_probability[0] = 0;
+		for (max_range_type_t i = 1;i <= m_max_syms;++i)
+			m_probability[i] = m_probability[i - 1] + (probability_type_t)stream->read(width);
+
+		return true;
+	}
+
+	private:
+	void release() {
+		delete[] m_counts;
+		delete[] m_probability;
+		m_counts = 0;
+		m_probability = 0;
+		m_max_syms = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef __scalable_range_dec_hpp__
+#define __scalable_range_dec_hpp__
+
+/*
+	Carry-less range decoder core shared by the adaptive , fixed alphabet and rebuilt model decoders
+	(counterpart of scalable_range_enc_c).
+
+	The deriving decoder finds the symbol with get_current_prob(total) in its own model and then
+	removes its interval with remove_range_interval().
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+*/
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_range_dec_c {
+	protected:
+	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
+	static const max_range_type_t k_low_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
+	static const max_range_type_t k_low_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2));
+	static const max_range_type_t k_hi_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1));
+	static const max_range_type_t k_max_range =  (max_range_type_t)k_low_bit_mask;
+	static const max_range_type_t k_probability_range_mask = (max_range_type_t)( ((probability_type_t)-1)  );
+	static const max_range_type_t k_preamble_chunk = (k_max_bits < (max_range_type_t)32) ? k_max_bits : (max_range_type_t)32;
+
+	bit_streams::bit_stream_reader_c<reader_type_c>* m_stream;
+	max_range_type_t m_high,m_low;
+	max_range_type_t m_tmp_range;
+	max_range_type_t m_code;
+	uint64_t m_bits_read;
+
+	scalable_range_dec_c() : m_stream(0),m_high(k_probability_range_mask),m_low(0),m_tmp_range(0),m_code(0),m_bits_read(0) { }
+
+	public:
+	//Total bits consumed from the stream since construction
+	inline uint64_t bits_read() const {
+		return m_bits_read;
+	}
+
+	protected:
+	//Starts a segment : resets the range and reads the preamble
+	inline void reset_range(bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		m_high = k_probability_range_mask;
+		m_low = 0;
+		m_tmp_range = 0;
+		m_stream = stream;
+		read_preamble();
+	}
+
+	//Same bits as k_max_bits single bit reads , fetched k_preamble_chunk bits at a time
+	void read_preamble() {
+		m_code = (max_range_type_t)m_stream->read(k_preamble_chunk);
+		for (max_range_type_t i = k_preamble_chunk;i < k_max_bits;i += k_preamble_chunk) {
+			m_code <<= k_preamble_chunk;
+			m_code |= (max_range_type_t)m_stream->read(k_preamble_chunk);
+		}
+
+		m_bits_read += (uint64_t)k_max_bits;
+	}
+
+	inline max_range_type_t get_current_prob(max_range_type_t range) {
+		m_tmp_range = (m_high-m_low)+(max_range_type_t)1;
+		return (max_range_type_t)(((((m_code-m_low)+(max_range_type_t)1)*range)-1)/m_tmp_range);
+	}
+
+	void remove_range_interval(const max_range_type_t sym_low,const max_range_type_t sym_high,const max_range_type_t total_range) {
+		m_tmp_range = (m_high-m_low)+(max_range_type_t)1;
+		m_high = m_low+((m_tmp_range*sym_high)/total_range)-(max_range_type_t)1;
+		m_low = m_low+((m_tmp_range*sym_low )/total_range);
+
+		do {
+			if((m_high & k_hi_bit_val) == (m_low & k_hi_bit_val)) {}
+			else {
+				if((m_low & k_low_bit_val) && !(m_high	& k_low_bit_val)) {
+					m_code ^= k_low_bit_val;
+					m_low &= k_low_bit_mask;
+					m_high |= k_low_bit_val;
+				}
+				else
+					return;
+			}
+			m_low = (m_low	<< (max_range_type_t)1) &	k_probability_range_mask;
+			m_high = ((m_high << (max_range_type_t)1) |	(max_range_type_t)1) & k_probability_range_mask;
+			m_code = ( (m_code << (max_range_type_t)1) | (max_range_type_t)m_stream->read(1) ) & k_probability_range_mask;
+			++m_bits_read;
+		} while (1);
+	}
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef __scalable_range_enc_hpp__
+#define __scalable_range_enc_hpp__
+
+/*
+	Carry-less range encoder core (Mark Nelson / Dimitry Subbotin) shared by the adaptive , fixed
+	alphabet and rebuilt model encoders.
+
+	It only codes intervals : the deriving coder owns the model and passes [low,high) of total for
+	every symbol. Members are protected so coders keep saving / restoring them directly.
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+*/
+
+#include "bit_streams.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_range_enc_c {
+	protected:
+	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
+	static const max_range_type_t k_hi_bit = k_max_bits - 1;
+	static const max_range_type_t k_low_bit = k_max_bits - 2;
+	static const max_range_type_t k_low_bit_mask = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
+	static const max_range_type_t k_low_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2));
+	static const max_range_type_t k_hi_bit_val = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)1));
+	static const max_range_type_t k_max_range =  (max_range_type_t)k_low_bit_mask;
+	static const max_range_type_t k_probability_range_mask = (max_range_type_t)( ((probability_type_t)-1)  ) ;
+
+	bit_streams::bit_stream_writer_c<writer_type_c>* m_stream;
+	max_range_type_t m_high,m_low,m_underflow_count;
+	max_range_type_t m_tmp_range;
+	uint64_t m_bits_written;
+	bool m_flushed;
+
+	scalable_range_enc_c() : m_stream(0),m_high(k_probability_range_mask),m_low(0),m_underflow_count(0),
+	m_tmp_range(0),m_bits_written(0),m_flushed(false) { }
+
+	public:
+	//Total bits emitted to the stream since construction (padding included)
+	inline uint64_t bits_written() const {
+		return m_bits_written;
+	}
+
+	protected:
+	inline void reset_range(bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		m_high = k_probability_range_mask;
+		m_low = 0;
+		m_underflow_count = 0;
+		m_tmp_range = 0;
+		m_flushed = false;
+		m_stream = stream;
+	}
+
+	//Final bits of the current segment : 2 bits plus the pending underflow bits
+	void finish_range() {
+		++m_underflow_count;
+		m_bits_written += (uint64_t)m_underflow_count + (uint64_t)1;
+		m_stream->write((m_low>>k_low_bit)&((max_range_type_t)1),1);
+		const max_range_type_t bstate = ((m_low>>k_low_bit)^((max_range_type_t)1))&1;
+		const uint64_t uf_mask = (bstate) ? (((uint64_t)-1)) : (uint64_t)0;
+
+		for (;m_underflow_count >= 64U;m_underflow_count -= 64U)
+			m_stream->write(uf_mask,64U);
+
+		if (m_underflow_count)
+			m_stream->write(uf_mask,m_underflow_count);
+
+		m_underflow_count=(max_range_type_t)0;
+		m_flushed=true;
+	}
+
+	//finish_range() emits 2 bits on top of one bit per renormalization shift while the decoder
+	//consumes k_max_bits on init, so k_max_bits - 2 bits are still owed
+	inline void pad_range() {
+		m_stream->write(0,k_max_bits - (max_range_type_t)2);
+		m_bits_written += (uint64_t)(k_max_bits - (max_range_type_t)2);
+	}
+
+	//Codes [sym_low,sym_high) of max_range , returns the bits emitted (counted only when simulating)
+	max_range_type_t range_code_interval(const max_range_type_t sym_low,const max_range_type_t sym_high,const max_range_type_t max_range,const bool simulate = false) {
+		max_range_type_t cost = 0;
+
+		m_tmp_range=(m_high-m_low)+(max_range_type_t)1;
+		m_high = m_low + ((m_tmp_range*sym_high)/max_range)- (max_range_type_t)1;
+		m_low = m_low + ((m_tmp_range*sym_low )/max_range);
+
+		do {
+			if ((m_high & k_hi_bit_val)==(m_low & k_hi_bit_val)) {
+				cost += m_underflow_count + 1;
+				if (!simulate) {
+					m_bits_written += (uint64_t)m_underflow_count + (uint64_t)1;
+					m_stream->write(m_high>>k_hi_bit,1);
+					const max_range_type_t bstate = (m_high>>k_hi_bit)^(max_range_type_t)1;
+					const uint64_t uf_mask = (bstate) ? (((uint64_t)-1)) : (uint64_t)0;
+
+					for (;m_underflow_count >= 64U;m_underflow_count -= 64U)
+						m_stream->write(uf_mask,64U);
+
+					if (m_underflow_count)
+						m_stream->write(uf_mask,m_underflow_count);
+				}
+				m_underflow_count=(max_range_type_t)0;
+
+			} else {
+				if((m_low & k_low_bit_val) && !(m_high & k_low_bit_val)) {
+					++m_underflow_count;
+					m_low	 &=	k_low_bit_mask;
+					m_high |=	k_low_bit_val;
+				}
+				else break;
+			}
+
+			m_low = (m_low<<(max_range_type_t)1) &	k_probability_range_mask;
+			m_high = ((m_high<<(max_range_type_t)1)|(max_range_type_t)1) & k_probability_range_mask;
+		} while (1);
+		return cost;
+	}
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef __scalable_rebuild_ac_hpp__
+#define __scalable_rebuild_ac_hpp__
+
+/*
+	Adaptive encoder with a periodically rebuilt model (see scalable_rebuild_model.hpp).
+
+	scalable_ac_c pays an O(max_syms) cumulative update for every symbol. Here each symbol only bumps
+	a plain counter and coding uses the cumulative table frozen at the last rebuild , so the per symbol
+	cost is O(1) plus the amortised rebuild. scalable_rebuild_adc_c drives the same model class and
+	follows the schedule exactly.
+
+	Example usage :
+		bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out; //requires my bitstreams lib
+		scalable_rebuild_ac_c<file_streams::file_stream_writer_c,uint32_t,uint64_t> coder;
+
+		out.open("out");
+		coder.init(256 + 1,&out);
+
+		for (i = 0;i < len;++i)
+			coder.encode_symbol(buffer[i]);
+
+		coder.encode_symbol(256); // eof
+		coder.flush();
+		out.close();
+*/
+
+#include "scalable_range_enc.hpp"
+#include "scalable_rebuild_model.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_rebuild_ac_c : public scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_enc_c<writer_type_c,probability_type_t,max_range_type_t> range_t;
+	typedef scalable_rebuild_model_c<probability_type_t,max_range_type_t> model_t;
+
+	public:
+	static const max_range_type_t k_default_max_interval = model_t::k_default_max_interval;
+	static const max_range_type_t k_default_drift_limit = model_t::k_default_drift_limit;
+
+	private:
+	using range_t::m_stream;
+	using range_t::m_flushed;
+	using range_t::reset_range;
+	using range_t::finish_range;
+	using range_t::pad_range;
+	using range_t::range_code_interval;
+
+	model_t m_model;
+
+	public:
+	~scalable_rebuild_ac_c() {
+		flush();
+	}
+
+	inline const probability_type_t* get_model() const {
+		return m_model.get_model();
+	}
+
+	bool flush(const bool force = false) {
+		if (!m_stream)
+			return false;
+
+		if ((!m_flushed) || force)
+			finish_range();
+
+		return false;
+	}
+
+	//See scalable_ac_c::flush_padded()
+	bool flush_padded() {
+		if ((!m_stream) || (m_flushed))
+			return false;
+
+		flush();
+		pad_range();
+		return true;
+	}
+
+	//drift_limit : rare symbols tolerated before an early rebuild (see scalable_rebuild_model.hpp)
+	bool init(max_range_type_t max_symbols,bit_streams::bit_stream_writer_c<writer_type_c>* stream,
+				const max_range_type_t max_interval = k_default_max_interval,const max_range_type_t drift_limit = k_default_drift_limit) {
+		flush();
+		if (!stream)
+			return false;
+
+		reset_range(stream);
+		return m_model.init(max_symbols,max_interval,drift_limit,false);
+	}
+
+	inline void encode_symbol(const max_range_type_t s) {
+		const probability_type_t* probability = m_model.get_model();
+
+		range_code_interval((max_range_type_t)probability[s],(max_range_type_t)probability[s + (max_range_type_t)1],m_model.total());
+		m_model.update(s);
+	}
+};
+
+#endif
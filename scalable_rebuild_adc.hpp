@@ -0,0 +1,69 @@
+#ifndef __scalable_rebuild_adc_hpp__
+#define __scalable_rebuild_adc_hpp__
+
+/*
+	Decoder for streams written by scalable_rebuild_ac_c (see scalable_rebuild_ac.hpp).
+
+	Every rebuild also derives a lookup table from the frozen cumulative table : the top
+	k_lookup_bits of a probability select the first candidate symbol, so decoding a symbol
+	is a table lookup plus a short forward scan instead of a search over the whole model.
+
+	Example usage :
+		bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> in; //requires my bitstreams lib
+		scalable_rebuild_adc_c<file_streams::file_stream_reader_c,uint32_t,uint64_t> decoder;
+
+		in.open("in");
+		decoder.init(256 + 1,&in);
+
+		while ((symbol = decoder.decode_symbol()) != 256)
+			std :: cout << symbol << std::endl;
+
+		in.close();
+*/
+
+#include "scalable_range_dec.hpp"
+#include "scalable_rebuild_model.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_rebuild_adc_c : public scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> {
+	typedef scalable_range_dec_c<reader_type_c,probability_type_t,max_range_type_t> range_t;
+	typedef scalable_rebuild_model_c<probability_type_t,max_range_type_t> model_t;
+
+	public:
+	static const max_range_type_t k_default_max_interval = model_t::k_default_max_interval;
+	static const max_range_type_t k_default_drift_limit = model_t::k_default_drift_limit;
+
+	private:
+	using range_t::reset_range;
+	using range_t::get_current_prob;
+	using range_t::remove_range_interval;
+
+	model_t m_model;
+
+	public:
+	inline const probability_type_t* get_model() const {
+		return m_model.get_model();
+	}
+
+	//max_interval and drift_limit must match the encoder's
+	bool init(max_range_type_t max_symbols,bit_streams::bit_stream_reader_c<reader_type_c>* stream,
+				const max_range_type_t max_interval = k_default_max_interval,const max_range_type_t drift_limit = k_default_drift_limit) {
+		if ((!stream) || (!m_model.init(max_symbols,max_interval,drift_limit,true)))
+			return false;
+
+		reset_range(stream);
+		return true;
+	}
+
+	max_range_type_t decode_symbol() {
+		const probability_type_t* probability = m_model.get_model();
+		const max_range_type_t total = m_model.total();
+		const max_range_type_t sym = m_model.find(get_current_prob(total));
+
+		remove_range_interval((max_range_type_t)probability[sym],(max_range_type_t)probability[sym + (max_range_type_t)1],total);
+		m_model.update(sym);
+		return sym;
+	}
+};
+
+#endif
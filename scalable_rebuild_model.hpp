@@ -0,0 +1,167 @@
+#ifndef __scalable_rebuild_model_hpp__
+#define __scalable_rebuild_model_hpp__
+
+/*
+	Periodically rebuilt model shared by scalable_rebuild_ac_c and scalable_rebuild_adc_c.
+
+	Each coded symbol only bumps a plain counter ; coding uses the cumulative table frozen at the last
+	rebuild. The table is rebuilt :
+		- every interval symbols (the interval doubles from k_min_interval up to max_interval)
+		- early , when the statistics drifted : a symbol occurred more than drift_limit times since the
+		  last rebuild and more than drift_limit + twice what the frozen table predicts for it.
+		  The interval then restarts from k_min_interval.
+		- when the counts are rescaled (total reaching k_max_range)
+
+	The schedule only depends on coded symbols , so encoder and decoder stay in lockstep as long as
+	both update the same model with the same symbols. Decoders init() it with lookup = true to get a
+	table from the top k_lookup_bits of a probability to the first candidate symbol (see find()).
+*/
+
+#include <stdint.h>
+
+template <typename probability_type_t,typename max_range_type_t>
+class scalable_rebuild_model_c {
+	public:
+	static const max_range_type_t k_min_interval = 32;
+	static const max_range_type_t k_default_max_interval = 4096;
+	static const max_range_type_t k_default_drift_limit = 16;
+	static const max_range_type_t k_lookup_bits = 10;
+
+	private:
+	static const max_range_type_t k_max_bits = sizeof(probability_type_t)<<(probability_type_t)3;
+	static const max_range_type_t k_max_range = ((max_range_type_t)1 << (max_range_type_t)(k_max_bits-(max_range_type_t)2)) - (max_range_type_t)1;
+	static const max_range_type_t k_lookup_size = (max_range_type_t)1 << k_lookup_bits;
+
+	probability_type_t* m_probability;	//Frozen cumulative table
+	max_range_type_t* m_counts;
+	max_range_type_t* m_lookup;
+	max_range_type_t m_max_syms;
+	max_range_type_t m_lookup_shift;
+	max_range_type_t m_count_total;
+	max_range_type_t m_interval,m_max_interval;
+	max_range_type_t m_since_rebuild;
+	max_range_type_t m_drift_limit;
+
+	public:
+	scalable_rebuild_model_c() : m_probability(0),m_counts(0),m_lookup(0),m_max_syms(0),m_lookup_shift(0),m_count_total(0),
+	m_interval(0),m_max_interval(0),m_since_rebuild(0),m_drift_limit(0) { }
+
+	~scalable_rebuild_model_c() {
+		release();
+	}
+
+	bool init(const max_range_type_t max_symbols,const max_range_type_t max_interval,const max_range_type_t drift_limit,const bool lookup) {
+		release();
+		if ((!max_symbols) || (max_symbols >= (k_max_range >> (max_range_type_t)1)))
+			return false;
+
+		m_probability = new probability_type_t[max_symbols + 1];
+		m_counts = new max_range_type_t[max_symbols];
+		m_lookup = (lookup) ? new max_range_type_t[k_lookup_size + 1] : 0;
+
+		if ((!m_probability) || (!m_counts) || (lookup && (!m_lookup))) {
+			release();
+			return false;
+		}
+
+		m_max_syms = max_symbols;
+		for (max_range_type_t i = 0;i < max_symbols;++i)
+			m_counts[i] = 1;
+
+		m_count_total = max_symbols;
+		m_max_interval = (max_interval > k_min_interval) ? max_interval : k_min_interval;
+		m_drift_limit = drift_limit;
+		rebuild(k_min_interval);
+		return true;
+	}
+
+	inline const probability_type_t* get_model() const {
+		return m_probability;
+	}
+
+	inline max_range_type_t total() const {
+		return (max_range_type_t)m_probability[m_max_syms];
+	}
+
+	//First symbol whose range ends above prob (decoders only)
+	inline max_range_type_t find(const max_range_type_t prob) const {
+		max_range_type_t sym = m_lookup[prob >> m_lookup_shift];
+
+		while ((max_range_type_t)m_probability[sym + (max_range_type_t)1] <= prob)
+			++sym;
+
+		return sym;
+	}
+
+	//Call once per coded symbol , after coding it with the frozen table
+	inline void update(const max_range_type_t s) {
+		const max_range_type_t freq = (max_range_type_t)(m_probability[s + (max_range_type_t)1] - m_probability[s]);
+		const max_range_type_t grown = ++m_counts[s] - freq;	//Counts never drop below the frozen table between rebuilds
+
+		++m_since_rebuild;
+		if (++m_count_total >= k_max_range) {
+			scale_counts();
+			rebuild(m_interval);
+			return;
+		}
+
+		//grown - drift_limit > 2 x expected growth (since_rebuild x freq / total)
+		if ((grown > m_drift_limit) && ((grown - m_drift_limit) * total() > (m_since_rebuild * freq) << (max_range_type_t)1))
+			rebuild(k_min_interval);
+		else if (m_since_rebuild >= m_interval)
+			rebuild((m_interval < m_max_interval) ? (m_interval << (max_range_type_t)1) : m_interval);
+	}
+
+	private:
+	void release() {
+		delete[] m_probability;
+		delete[] m_counts;
+		delete[] m_lookup;
+		m_probability = 0;
+		m_counts = 0;
+		m_lookup = 0;
+		m_max_syms = 0;
+	}
+
+	void scale_counts() {
+		m_count_total = 0;
+		for (max_range_type_t i = 0;i < m_max_syms;++i) {
+			m_counts[i] = (m_counts[i] + (max_range_type_t)1) >> (max_range_type_t)1;
+			m_count_total += m_counts[i];
+		}
+	}
+
+	void rebuild(const max_range_type_t interval) {
+		m_probability[0] = 0;
+		for (max_range_type_t i = 0;i < m_max_syms;++i)
+			m_probability[i + 1] = m_probability[i] + (probability_type_t)m_counts[i];
+
+		m_interval = interval;
+		m_since_rebuild = 0;
+
+		if (m_lookup)
+			rebuild_lookup();
+	}
+
+	//Bucket b holds the first symbol whose range reaches b << m_lookup_shift
+	void rebuild_lookup() {
+		const max_range_type_t total_range = total();
+		max_range_type_t buckets;
+
+		m_lookup_shift = 0;
+		while ((total_range - (max_range_type_t)1) >> m_lookup_shift >= k_lookup_size)
+			++m_lookup_shift;
+
+		buckets = ((total_range - (max_range_type_t)1) >> m_lookup_shift) + (max_range_type_t)1;
+		for (max_range_type_t b = 0,sym = 0;b < buckets;++b) {
+			const max_range_type_t base = b << m_lookup_shift;
+
+			while ((max_range_type_t)m_probability[sym + (max_range_type_t)1] <= base)
+				++sym;
+
+			m_lookup[b] = sym;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef __scalable_sync_ac_hpp__
+#define __scalable_sync_ac_hpp__
+
+/*
+	Adaptive encoder with periodic sync points for random access decoding (see scalable_sync_adc.hpp).
+
+	Every symbol_interval symbols (and/or once bit_interval bits have been written) the coder is
+	restart()ed : the range coder is flushed and padded, and the model at that point is recorded
+	together with the symbol index and the bit offset of the new segment. The model keeps adapting
+	across segments so the ratio loss is only the flush/padding bits per sync point.
+
+	Bit offsets are relative to the stream position at init(). The index is written separately with
+	write_index() (e.g. to a side file or after the payload).
+
+	Index layout :
+		32 bits max_syms | 64 bits symbol count | 32 bits point count
+		per point : 64 bits symbol | 64 bits bit offset | 6 bits width | max_syms x width bits frequencies
+
+	Example usage :
+		bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out,idx; //requires my bitstreams lib
+		scalable_sync_ac_c<file_streams::file_stream_writer_c,uint32_t,uint64_t> coder;
+
+		out.open("out");
+		coder.init(256,&out,1U << 16U);
+
+		for (i = 0;i < len;++i)
+			coder.encode_symbol(buffer[i]);
+
+		coder.flush();
+		out.close();
+
+		idx.open("out.idx");
+		coder.write_index(&idx);
+		idx.close();
+*/
+
+#include "scalable_ac.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_sync_ac_c {
+	public:
+	struct sync_point_t {
+		uint64_t symbol;
+		uint64_t bit_offset;
+		probability_type_t* probability;
+	};
+
+	static const uint32_t k_width_bits = 6;
+
+	private:
+	scalable_ac_c<writer_type_c,probability_type_t,max_range_type_t> m_coder;
+	sync_point_t* m_points;
+	uint32_t m_point_count,m_point_capacity;
+	uint64_t m_symbol;
+	uint64_t m_symbol_interval,m_bit_interval;
+	uint64_t m_bit_base;
+	max_range_type_t m_max_syms;
+
+	public:
+	scalable_sync_ac_c() : m_points(0),m_point_count(0),m_point_capacity(0),m_symbol(0),
+	m_symbol_interval(0),m_bit_interval(0),m_bit_base(0),m_max_syms(0) { }
+
+	~scalable_sync_ac_c() {
+		release();
+	}
+
+	//An interval of 0 disables that trigger
+	bool init(max_range_type_t max_symbols,bit_streams::bit_stream_writer_c<writer_type_c>* stream,
+				const uint64_t symbol_interval,const uint64_t bit_interval = 0) {
+		release();
+		if (!m_coder.init(max_symbols,stream))
+			return false;
+
+		m_max_syms = max_symbols;
+		m_symbol = 0;
+		m_symbol_interval = symbol_interval;
+		m_bit_interval = bit_interval;
+		m_bit_base = m_coder.bits_written();
+
+		//Point 0 : start of stream , initial model
+		return add_point(0);
+	}
+
+	inline void encode_symbol(const max_range_type_t s) {
+		const sync_point_t& last = m_points[m_point_count - 1];
+
+		if (((m_symbol_interval) && (m_symbol - last.symbol >= m_symbol_interval)) ||
+			((m_bit_interval) && (m_coder.bits_written() - m_bit_base - last.bit_offset >= m_bit_interval))) {
+			m_coder.restart();
+			add_point(m_coder.bits_written() - m_bit_base);
+		}
+
+		m_coder.encode_symbol(s);
+		++m_symbol;
+	}
+
+	inline bool flush() {
+		return m_coder.flush_padded();
+	}
+
+	inline uint32_t get_point_count() const {
+		return m_point_count;
+	}
+
+	inline const sync_point_t* get_points() const {
+		return m_points;
+	}
+
+	template <class index_writer_type_c>
+	bool write_index(bit_streams::bit_stream_writer_c<index_writer_type_c>* stream) const {
+		if ((!stream) || (!m_point_count))
+			return false;
+
+		stream->write(m_max_syms,32);
+		stream->write(m_symbol,64);
+		stream->write(m_point_count,32);
+
+		for (uint32_t i = 0;i < m_point_count;++i) {
+			const probability_type_t* p = m_points[i].probability;
+			max_range_type_t hi = 0;
+			uint32_t width = 0;
+
+			stream->write(m_points[i].symbol,64);
+			stream->write(m_points[i].bit_offset,64);
+
+			for (max_range_type_t j = 1;j <= m_max_syms;++j)
+				hi |= (max_range_type_t)(p[j] - p[j - 1]);
+
+			for (;hi;hi >>= (max_range_type_t)1)
+				++width;
+
+			stream->write(width,k_width_bits);
+			if (width) {
+				for (max_range_type_t j = 1;j <= m_max_syms;++j)
+					stream->write(p[j] - p[j - 1],width);
+			}
+		}
+
+		return true;
+	}
+
+	private:
+	bool add_point(const uint64_t bit_offset) {
+		if (m_point_count == m_point_capacity) {
+			const uint32_t capacity = (m_point_capacity) ? (m_point_capacity << 1U) : 16U;
+			sync_point_t* points = new sync_point_t[capacity];
+			if (!points)
+				return false;
+
+			for (uint32_t i = 0;i < m_point_count;++i)
+				points[i] = m_points[i];
+
+			delete[] m_points;
+			m_points = points;
+			m_point_capacity = capacity;
+		}
+
+		sync_point_t& point = m_points[m_point_count];
+		const probability_type_t* model = m_coder.get_model();
+
+		point.probability = new probability_type_t[m_max_syms + 1];
+		if (!point.probability)
+			return false;
+
+		for (max_range_type_t i = 0;i <= m_max_syms;++i)
+			point.probability[i] = model[i];
+
+		point.symbol = m_symbol;
+		point.bit_offset = bit_offset;
+		++m_point_count;
+		return true;
+	}
+
+	void release() {
+		for (uint32_t i = 0;i < m_point_count;++i)
+			delete[] m_points[i].probability;
+
+		delete[] m_points;
+		m_points = 0;
+		m_point_count = 0;
+		m_point_capacity = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef __scalable_sync_adc_hpp__
+#define __scalable_sync_adc_hpp__
+
+/*
+	Random access decoder for streams written by scalable_sync_ac_c.
+
+	seek() jumps to the closest sync point at or before the requested symbol, restores the model
+	recorded there and decodes only the symbols in between. Seeking forward inside the current
+	segment just decodes ahead , any other seek positions the stream at the sync point's byte
+	(bit_stream_reader_c::seek() , which seeks the underlying file_streams reader) and skips the
+	remaining 0-7 bits , so random access costs no I/O proportional to the offset.
+
+	Example usage :
+		bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> idx; //requires my bitstreams lib
+		scalable_sync_adc_c<file_streams::file_stream_reader_c,uint32_t,uint64_t> decoder;
+
+		idx.open("in.idx");
+		decoder.read_index(&idx);
+		idx.close();
+
+		decoder.open("in");
+		decoder.seek(first);
+
+		for (i = first;i < last;++i)
+			std :: cout << decoder.decode_symbol() << std::endl;
+*/
+
+#include "scalable_adc.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t>
+class scalable_sync_adc_c {
+	public:
+	struct sync_point_t {
+		uint64_t symbol;
+		uint64_t bit_offset;
+		probability_type_t* probability;
+	};
+
+	static const uint32_t k_width_bits = 6;
+
+	private:
+	typedef scalable_adc_c<reader_type_c,probability_type_t,max_range_type_t> decoder_t;
+
+	bit_streams::bit_stream_reader_c<reader_type_c> m_in;
+	decoder_t m_decoder;
+	const char* m_file;
+	sync_point_t* m_points;
+	uint32_t m_point_count;
+	uint32_t m_next_point;
+	uint64_t m_symbol_count;
+	uint64_t m_symbol;
+	uint64_t m_bit_base;		//Bit offset of the coded data in the file
+	max_range_type_t m_max_syms;
+	bool m_positioned;
+
+	public:
+	scalable_sync_adc_c() : m_file(0),m_points(0),m_point_count(0),m_next_point(0),m_symbol_count(0),m_symbol(0),
+	m_bit_base(0),m_max_syms(0),m_positioned(false) { }
+
+	~scalable_sync_adc_c() {
+		release();
+		close();
+	}
+
+	template <class index_reader_type_c>
+	bool read_index(bit_streams::bit_stream_reader_c<index_reader_type_c>* stream) {
+		release();
+		if (!stream)
+			return false;
+
+		m_max_syms = (max_range_type_t)stream->read(32);
+		m_symbol_count = (uint64_t)stream->read(64);
+		m_point_count = (uint32_t)stream->read(32);
+
+		if ((!m_max_syms) || (!m_point_count))
+			return false;
+
+		m_points = new sync_point_t[m_point_count];
+		if (!m_points)
+			return false;
+
+		for (uint32_t i = 0;i < m_point_count;++i)
+			m_points[i].probability = 0;
+
+		for (uint32_t i = 0;i < m_point_count;++i) {
+			probability_type_t* p = new probability_type_t[m_max_syms + 1];
+			uint32_t width;
+
+			if (!p)
+				return false;
+
+			m_points[i].probability = p;
+			m_points[i].symbol = (uint64_t)stream->read(64);
+			m_points[i].bit_offset = (uint64_t)stream->read(64);
+
+			width = (uint32_t)stream->read(k_width_bits);
+			p[0] = 0;
+			for (max_range_type_t j = 1;j <= m_max_syms;++j)
+				p[j] = p[j - 1] + ((width) ? (probability_type_t)stream->read(width) : (probability_type_t)0);
+		}
+
+		m_positioned = false;
+		return true;
+	}
+
+	//bit_offset is where the encoder's init() happened in the file
+	bool open(const char* file,const uint64_t bit_offset = 0) {
+		close();
+		if ((!file) || (!m_in.open(file)))
+			return false;
+
+		m_file = file;
+		m_bit_base = bit_offset;
+		m_positioned = false;
+		return true;
+	}
+
+	void close() {
+		if (!m_file)
+			return;
+
+		m_in.close();
+		m_file = 0;
+	}
+
+	inline uint64_t get_symbol_count() const {
+		return m_symbol_count;
+	}
+
+	bool seek(const uint64_t symbol) {
+		if ((!m_file) || (!m_point_count) || (symbol > m_symbol_count))
+			return false;
+
+		const uint32_t target = find_point(symbol);
+
+		//Unless the target is ahead of us in the current segment , jump to its sync point
+		if ((!m_positioned) || (m_symbol > symbol) || (m_next_point <= target)) {
+			const sync_point_t& point = m_points[target];
+			const uint64_t offset = m_bit_base + point.bit_offset;
+
+			m_in.seek(offset >> (uint64_t)3);
+			if (offset & (uint64_t)7)
+				m_in.read((uint32_t)(offset & (uint64_t)7));
+
+			if (!enter_point(target))
+				return false;
+		}
+
+		while (m_symbol < symbol)
+			decode_symbol();
+
+		return true;
+	}
+
+	inline max_range_type_t decode_symbol() {
+		if (!m_positioned)
+			seek(0);
+
+		//Encoder restarted here : the previous segment was padded so the preamble starts right away
+		if ((m_next_point < m_point_count) && (m_symbol == m_points[m_next_point].symbol)) {
+			m_decoder.restart();
+			++m_next_point;
+		}
+
+		++m_symbol;
+		return m_decoder.decode_symbol();
+	}
+
+	private:
+	uint32_t find_point(const uint64_t symbol) const {
+		uint32_t lo = 0,hi = m_point_count;
+
+		while (hi - lo > 1U) {
+			const uint32_t mid = (lo + hi) >> 1U;
+			if (m_points[mid].symbol <= symbol)
+				lo = mid;
+			else
+				hi = mid;
+		}
+
+		return lo;
+	}
+
+	bool enter_point(const uint32_t index) {
+		typename decoder_t::scalable_adc_state_t state = typename decoder_t::scalable_adc_state_t();	//Zeroed : run mode stays off
+		const sync_point_t& point = m_points[index];
+
+		state.max_syms = m_max_syms;
+		state.probability = point.probability;
+
+		if (!m_decoder.restore_state(&state,false))
+			return false;
+
+		if (!m_decoder.restart(&m_in))
+			return false;
+
+		m_symbol = point.symbol;
+		m_next_point = index + 1U;
+		m_positioned = true;
+		return true;
+	}
+
+	void release() {
+		for (uint32_t i = 0;i < m_point_count;++i)
+			delete[] m_points[i].probability;
+
+		delete[] m_points;
+		m_points = 0;
+		m_point_count = 0;
+		m_next_point = 0;
+		m_positioned = false;
+	}
+};
+
+#endif
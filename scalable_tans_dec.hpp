@@ -0,0 +1,114 @@
+#ifndef __scalable_tans_dec_hpp__
+#define __scalable_tans_dec_hpp__
+
+/*
+	Table driven tANS decoder for streams written by scalable_tans_enc_c.
+
+	Every symbol is one table lookup plus one bit read. The decoder consumes exactly the bits the
+	encoder wrote so other data may follow in the same bitstream.
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+
+	Example usage :
+		bit_streams::bit_stream_reader_c<file_streams::file_stream_reader_c> in; //requires my bitstreams lib
+		scalable_tans_dec_c<file_streams::file_stream_reader_c,uint16_t,uint32_t> decoder;
+
+		in.open("in");
+		decoder.init<uint32_t>(probs,count,256,&in);
+
+		for (i = 0;i < count;++i)
+			buffer[i] = decoder.decode_symbol();
+
+		in.close();
+*/
+
+#include "scalable_tans_table.hpp"
+
+template <class reader_type_c,typename probability_type_t,typename max_range_type_t,uint32_t table_log = 12>
+class scalable_tans_dec_c {
+	private:
+	typedef scalable_tans_table_c<probability_type_t,max_range_type_t,table_log> table_t;
+
+	static const max_range_type_t k_table_size = table_t::k_table_size;
+	static const uint32_t k_block_size = table_t::k_block_size;
+
+	struct entry_t {
+		max_range_type_t symbol;
+		probability_type_t base;
+		uint8_t bits;
+	};
+
+	bit_streams::bit_stream_reader_c<reader_type_c>* m_stream;
+	entry_t* m_table;
+	max_range_type_t m_state;
+	uint32_t m_left;
+
+	public:
+	scalable_tans_dec_c() : m_stream(0),m_table(0),m_state(0),m_left(0) { }
+	~scalable_tans_dec_c() { delete[] m_table; }
+
+	template <typename base_t>
+	bool init(const base_t* symbol_real_frequencies,const max_range_type_t count,max_range_type_t max_symbols,bit_streams::bit_stream_reader_c<reader_type_c>* stream) {
+		if ((!stream) || (!max_symbols) || (!count))
+			return false;
+
+		m_stream = stream;
+		m_state = 0;
+		m_left = 0;
+
+		delete[] m_table;
+		m_table = new entry_t[k_table_size];
+		if (!m_table)
+			return false;
+
+		probability_type_t* norm = new probability_type_t[max_symbols];
+		max_range_type_t* symbols = new max_range_type_t[k_table_size];
+
+		if ((!norm) || (!symbols) || (!table_t::normalize(symbol_real_frequencies,max_symbols,norm))) {
+			delete[] norm;
+			delete[] symbols;
+			delete[] m_table;
+			m_table = 0;
+			return false;
+		}
+
+		table_t::spread(norm,max_symbols,symbols);
+
+		//norm[] doubles as the running sub-state of each symbol
+		for (max_range_type_t u = 0;u < k_table_size;++u) {
+			const max_range_type_t s = symbols[u];
+			const max_range_type_t x = (max_range_type_t)(norm[s]++);
+			const max_range_type_t nb = (max_range_type_t)table_log - table_t::floor_log2(x);
+
+			m_table[u].symbol = s;
+			m_table[u].bits = (uint8_t)nb;
+			m_table[u].base = (probability_type_t)((x << nb) - k_table_size);
+		}
+
+		delete[] norm;
+		delete[] symbols;
+		return true;
+	}
+
+	inline max_range_type_t decode_symbol() {
+		if (!m_left) {
+			m_state = (max_range_type_t)m_stream->read(table_log);
+			m_left = k_block_size;
+		}
+
+		const entry_t& e = m_table[m_state];
+		m_state = (max_range_type_t)e.base;
+		if (e.bits)
+			m_state += (max_range_type_t)m_stream->read(e.bits);
+
+		--m_left;
+		return e.symbol;
+	}
+};
+
+#endif
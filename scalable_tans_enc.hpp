@@ -0,0 +1,195 @@
+#ifndef __scalable_tans_enc_hpp__
+#define __scalable_tans_enc_hpp__
+
+/*
+	Table driven tANS encoder for static distributions.
+
+	Takes the same frequency table as the static init() overload of scalable_ac_c, normalizes it to
+	1 << table_log slots and codes every symbol with a table lookup and a single bit write.
+	The model never adapts : use scalable_ac_c when it has to.
+
+	ANS is LIFO so symbols are buffered and each block of k_block_size symbols is encoded backwards
+	on flush, then written front to back (final state first) so the decoder reads forwards.
+	The decoder expects full blocks until the last one : flush() once, at the end of the stream.
+
+	Dependencies :
+	Requires my bitstream library
+	https://github.com/DimitrisVlachos/lib_bitstreams
+
+	License :
+		MIT
+
+	Example usage :
+		bit_streams::bit_stream_writer_c<file_streams::file_stream_writer_c> out; //requires my bitstreams lib
+		scalable_tans_enc_c<file_streams::file_stream_writer_c,uint16_t,uint32_t> coder;
+
+		out.open("out");
+		coder.init<uint32_t>(probs,count,256,&out);
+
+		for (i = 0;i < count;++i)
+			coder.encode_symbol(buffer[i]);
+
+		coder.flush();
+		out.close();
+*/
+
+#include "bit_streams.hpp"
+#include "scalable_tans_table.hpp"
+
+template <class writer_type_c,typename probability_type_t,typename max_range_type_t,uint32_t table_log = 12>
+class scalable_tans_enc_c {
+	private:
+	typedef scalable_tans_table_c<probability_type_t,max_range_type_t,table_log> table_t;
+
+	static const max_range_type_t k_table_size = table_t::k_table_size;
+	static const uint32_t k_block_size = table_t::k_block_size;
+
+	bit_streams::bit_stream_writer_c<writer_type_c>* m_stream;
+	max_range_type_t m_max_syms;
+	probability_type_t* m_norm;
+	max_range_type_t* m_start;
+	max_range_type_t* m_max_bits;
+	max_range_type_t* m_threshold;
+	probability_type_t* m_states;
+	max_range_type_t* m_pending;
+	max_range_type_t* m_bits;
+	uint8_t* m_nb;
+	uint32_t m_pending_count;
+
+	public:
+	scalable_tans_enc_c() : m_stream(0),m_max_syms(0),m_norm(0),m_start(0),m_max_bits(0),m_threshold(0),
+	m_states(0),m_pending(0),m_bits(0),m_nb(0),m_pending_count(0) { }
+
+	~scalable_tans_enc_c() {
+		flush();
+		release();
+	}
+
+	template <typename base_t>
+	bool init(const base_t* symbol_real_frequencies,const max_range_type_t count,max_range_type_t max_symbols,bit_streams::bit_stream_writer_c<writer_type_c>* stream) {
+		flush();
+		if ((!stream) || (!max_symbols) || (!count))
+			return false;
+
+		release();
+		m_stream = stream;
+		m_max_syms = max_symbols;
+		m_pending_count = 0;
+
+		m_norm = new probability_type_t[max_symbols];
+		m_start = new max_range_type_t[max_symbols];
+		m_max_bits = new max_range_type_t[max_symbols];
+		m_threshold = new max_range_type_t[max_symbols];
+		m_states = new probability_type_t[k_table_size];
+		m_pending = new max_range_type_t[k_block_size];
+		m_bits = new max_range_type_t[k_block_size];
+		m_nb = new uint8_t[k_block_size];
+
+		if ((!m_norm) || (!m_start) || (!m_max_bits) || (!m_threshold) || (!m_states) || (!m_pending) || (!m_bits) || (!m_nb)) {
+			release();
+			return false;
+		}
+
+		if (!table_t::normalize(symbol_real_frequencies,max_symbols,m_norm)) {
+			release();
+			return false;
+		}
+
+		return build_tables();
+	}
+
+	inline void encode_symbol(const max_range_type_t s) {
+		m_pending[m_pending_count] = s;
+		if (++m_pending_count == k_block_size)
+			encode_block();
+	}
+
+	bool flush() {
+		if ((!m_stream) || (!m_pending_count))
+			return false;
+
+		encode_block();
+		return true;
+	}
+
+	private:
+	void release() {
+		delete[] m_norm;
+		delete[] m_start;
+		delete[] m_max_bits;
+		delete[] m_threshold;
+		delete[] m_states;
+		delete[] m_pending;
+		delete[] m_bits;
+		delete[] m_nb;
+
+		m_norm = 0;
+		m_start = 0;
+		m_max_bits = 0;
+		m_threshold = 0;
+		m_states = 0;
+		m_pending = 0;
+		m_bits = 0;
+		m_nb = 0;
+		m_pending_count = 0;
+	}
+
+	bool build_tables() {
+		max_range_type_t* symbols = new max_range_type_t[k_table_size];
+		if (!symbols)
+			return false;
+
+		table_t::spread(m_norm,m_max_syms,symbols);
+
+		for (max_range_type_t s = 0,cumul = 0;s < m_max_syms;++s) {
+			const max_range_type_t n = (max_range_type_t)m_norm[s];
+
+			m_start[s] = cumul;
+			cumul += n;
+
+			if (n) {
+				m_max_bits[s] = (max_range_type_t)table_log - table_t::floor_log2(n);
+				m_threshold[s] = n << m_max_bits[s];
+			} else {
+				m_max_bits[s] = 0;
+				m_threshold[s] = 0;
+			}
+		}
+
+		//The k-th slot (in table order) of symbol s encodes sub-state norm[s] + k
+		for (max_range_type_t u = 0;u < k_table_size;++u) {
+			const max_range_type_t s = symbols[u];
+			m_states[m_start[s]++] = (probability_type_t)(k_table_size + u);
+		}
+
+		for (max_range_type_t s = 0;s < m_max_syms;++s)
+			m_start[s] -= (max_range_type_t)m_norm[s];
+
+		delete[] symbols;
+		return true;
+	}
+
+	void encode_block() {
+		max_range_type_t x = k_table_size;
+
+		for (uint32_t i = m_pending_count;i--;) {
+			const max_range_type_t s = m_pending[i];
+			const max_range_type_t nb = m_max_bits[s] - ((x < m_threshold[s]) ? (max_range_type_t)1 : (max_range_type_t)0);
+
+			m_bits[i] = x & (((max_range_type_t)1 << nb) - (max_range_type_t)1);
+			m_nb[i] = (uint8_t)nb;
+			x = (max_range_type_t)m_states[m_start[s] + (x >> nb) - (max_range_type_t)m_norm[s]];
+		}
+
+		m_stream->write(x - k_table_size,table_log);
+
+		for (uint32_t i = 0;i < m_pending_count;++i) {
+			if (m_nb[i])
+				m_stream->write(m_bits[i],m_nb[i]);
+		}
+
+		m_pending_count = 0;
+	}
+};
+
+#endif
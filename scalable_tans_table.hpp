@@ -0,0 +1,110 @@
+#ifndef __scalable_tans_table_hpp__
+#define __scalable_tans_table_hpp__
+
+/*
+	Shared table construction for the tANS (table driven asymmetric numeral systems) coders.
+
+	Both sides must build bit identical tables from the same frequency table so normalization
+	and symbol spreading live here instead of being duplicated in the encoder and the decoder.
+
+	Frequencies are normalized to a total of 1 << table_log (every present symbol keeps at least one slot)
+	and spread over the table with the usual FSE step.
+*/
+
+#include <stdint.h>
+
+template <typename probability_type_t,typename max_range_type_t,uint32_t table_log>
+class scalable_tans_table_c {
+	public:
+	static const max_range_type_t k_table_size = (max_range_type_t)1 << (max_range_type_t)table_log;
+	static const max_range_type_t k_table_mask = k_table_size - (max_range_type_t)1;
+	static const uint32_t k_block_size = 1U << 16U;	//Symbols per tANS block , independent of max_range_type_t (may be 16 bits)
+
+	//Table log must be large enough for the spread step to be coprime with the table size and
+	//small enough for states ( < 2 * table size ) to fit in probability_type_t
+	static const bool k_valid = (table_log >= 5U) && (table_log < (sizeof(probability_type_t) << 3U));
+
+	static inline max_range_type_t floor_log2(max_range_type_t v) {
+		max_range_type_t r = 0;
+		while (v >>= (max_range_type_t)1)
+			++r;
+
+		return r;
+	}
+
+	template <typename base_t>
+	static bool normalize(const base_t* symbol_real_frequencies,const max_range_type_t max_symbols,probability_type_t* norm) {
+		uint64_t total = 0;
+		max_range_type_t present = 0,largest = 0,sum = 0;
+
+		if ((!k_valid) || (!max_symbols))
+			return false;
+
+		for (max_range_type_t i = 0;i < max_symbols;++i) {
+			total += (uint64_t)symbol_real_frequencies[i];
+			if (symbol_real_frequencies[i])
+				++present;
+		}
+
+		if ((!total) || (present > k_table_size))
+			return false;
+
+		for (max_range_type_t i = 0;i < max_symbols;++i) {
+			const uint64_t f = (uint64_t)symbol_real_frequencies[i];
+			max_range_type_t n = 0;
+
+			if (f) {
+				n = (max_range_type_t)((f * (uint64_t)k_table_size) / total);
+				if (!n)
+					n = 1;
+			}
+
+			norm[i] = (probability_type_t)n;
+			sum += n;
+			if (norm[i] > norm[largest])
+				largest = i;
+		}
+
+		if (sum < k_table_size) {
+			norm[largest] += (probability_type_t)(k_table_size - sum);
+			return true;
+		}
+
+		//Rounding singletons up overshot the table : take the excess from the largest symbol first
+		if (sum > k_table_size) {
+			max_range_type_t excess = sum - k_table_size;
+			max_range_type_t take = (max_range_type_t)norm[largest] - (max_range_type_t)1;
+
+			if (take > excess)
+				take = excess;
+
+			norm[largest] -= (probability_type_t)take;
+			excess -= take;
+
+			while (excess) {
+				for (max_range_type_t i = 0;(i < max_symbols) && excess;++i) {
+					if (norm[i] > (probability_type_t)1) {
+						--norm[i];
+						--excess;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	static void spread(const probability_type_t* norm,const max_range_type_t max_symbols,max_range_type_t* symbols) {
+		const max_range_type_t step = (k_table_size >> (max_range_type_t)1) + (k_table_size >> (max_range_type_t)3) + (max_range_type_t)3;
+		max_range_type_t pos = 0;
+
+		for (max_range_type_t s = 0;s < max_symbols;++s) {
+			for (max_range_type_t i = 0,j = (max_range_type_t)norm[s];i < j;++i) {
+				symbols[pos] = s;
+				pos = (pos + step) & k_table_mask;
+			}
+		}
+	}
+};
+
+#endif